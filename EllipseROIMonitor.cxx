@@ -0,0 +1,103 @@
+// Print the ROI records published by vtkEllipseROIPublisher.
+//
+// Usage: EllipseROIMonitor [--name NAME]
+//
+// The shared memory segment (/vtkEllipseROI by default) is polled every
+// 100 microseconds; every new record is printed with its age, the time from
+// its publication to its reading. Records overwritten before they were read
+// are reported as skipped. The segment is reopened when the publisher
+// closes it. This program does not depend on VTK.
+
+#include <vtkEllipseROISharedMemory.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+static void Usage(const char *program)
+{
+	std::cerr << "Usage: " << program << " [--name NAME]\n";
+}
+
+static int64_t Now()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+static void Sleep(long nanoseconds)
+{
+	struct timespec duration = { 0, nanoseconds };
+	nanosleep(&duration, nullptr);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *name = "/vtkEllipseROI";
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--name") && i + 1 < argc)
+		{
+			name = argv[++i];
+		}
+		else
+		{
+			Usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	static const char *events[] = { "interaction", "end", "explicit" };
+	vtkEllipseROISharedMemoryReader reader;
+	uint64_t next = 1;
+	for (;;)
+	{
+		if (reader.IsClosed())
+		{
+			if (reader.Open(name))
+			{
+				// Only the records still in the ring can be read
+				uint64_t head = reader.GetHead();
+				uint64_t slots = reader.GetNumberOfSlots();
+				std::cout << "Opened " << name << ", " << slots << " slots\n";
+				next = head > slots ? head - slots + 1 : 1;
+			}
+			else
+			{
+				Sleep(100000000);
+				continue;
+			}
+		}
+
+		uint64_t head = reader.GetHead();
+		for (; next <= head; next++)
+		{
+			vtkEllipseROIRecord record;
+			if (!reader.Read(next, record))
+			{
+				std::cout << "Skipped record " << next << "\n";
+				continue;
+			}
+			char line[256];
+			snprintf(line, sizeof(line),
+				"%6llu %-11s %s center (%g, %g) radius (%g, %g) age %.1f us",
+				static_cast<unsigned long long>(record.Sequence),
+				record.Event < 3 ? events[record.Event] : "?",
+				record.Coordinates == vtkEllipseROIRecord::WORLD ? "world" : "display",
+				record.Center[0], record.Center[1], record.Radius[0], record.Radius[1],
+				1e-3 * static_cast<double>(Now() - record.Time));
+			std::cout << line;
+			if (record.HasStatistics)
+			{
+				snprintf(line, sizeof(line), " mean %g sd %g count %g",
+					record.Mean, record.StandardDeviation, record.Count);
+				std::cout << line;
+			}
+			std::cout << std::endl;
+		}
+		Sleep(100000);
+	}
+}
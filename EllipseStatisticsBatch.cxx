@@ -0,0 +1,388 @@
+// Compute ellipse ROI statistics for many studies without a render window.
+//
+// Usage: EllipseStatisticsBatch rois.csv [-o output.csv] [--prefetch N]
+//                               [--threads N] [--partial-volume] [--reproducible]
+//
+// Each line of rois.csv defines one ROI: image,slice,cx,cy,rx,ry (center and
+// semi-axes in world coordinates). Lines starting with '#' and a header line
+// are ignored. The ROIs of an image are grouped into a study, and a reader
+// thread loads the next studies while the current one is measured. One line
+// of statistics is written per ROI, and the throughput and peak memory are
+// reported on stderr.
+
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkImageReader2.h>
+#include <vtkImageReader2Factory.h>
+#include <vtkMetaImageReader.h>
+#include <vtkNIFTIImageReader.h>
+#include <vtkXMLImageDataReader.h>
+#include <vtkSMPTools.h>
+#include <vtkEllipseStatistics.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct ROI
+{
+	int Slice;
+	double Center[2];
+	double Radius[2];
+};
+
+struct Study
+{
+	std::string FileName;
+	std::vector<ROI> ROIs;
+	vtkSmartPointer<vtkImageData> Image;
+};
+
+// Bounded queue between the reader thread and the main thread
+class StudyQueue
+{
+public:
+	explicit StudyQueue(size_t capacity) : Capacity(std::max<size_t>(capacity, 1)), Done(false) {}
+
+	void Push(Study *study)
+	{
+		std::unique_lock<std::mutex> lock(this->Mutex);
+		this->NotFull.wait(lock, [this] { return this->Studies.size() < this->Capacity; });
+		this->Studies.push_back(study);
+		this->NotEmpty.notify_one();
+	}
+
+	void Close()
+	{
+		std::lock_guard<std::mutex> lock(this->Mutex);
+		this->Done = true;
+		this->NotEmpty.notify_all();
+	}
+
+	// Return nullptr when the queue is closed and empty
+	Study *Pop()
+	{
+		std::unique_lock<std::mutex> lock(this->Mutex);
+		this->NotEmpty.wait(lock, [this] { return !this->Studies.empty() || this->Done; });
+		if (this->Studies.empty())
+		{
+			return nullptr;
+		}
+		Study *study = this->Studies.front();
+		this->Studies.pop_front();
+		this->NotFull.notify_one();
+		return study;
+	}
+
+private:
+	size_t Capacity;
+	bool Done;
+	std::deque<Study*> Studies;
+	std::mutex Mutex;
+	std::condition_variable NotFull;
+	std::condition_variable NotEmpty;
+};
+
+static bool EndsWith(const std::string &s, const char *suffix)
+{
+	size_t n = strlen(suffix);
+	if (s.size() < n)
+	{
+		return false;
+	}
+	std::string tail = s.substr(s.size() - n);
+	std::transform(tail.begin(), tail.end(), tail.begin(), ::tolower);
+	return tail == suffix;
+}
+
+// Read an image with the reader matching its extension, nullptr on failure
+static vtkSmartPointer<vtkImageData> ReadImage(const std::string &fileName)
+{
+	vtkSmartPointer<vtkAlgorithm> reader;
+	if (EndsWith(fileName, ".vti"))
+	{
+		vtkSmartPointer<vtkXMLImageDataReader> xml = vtkSmartPointer<vtkXMLImageDataReader>::New();
+		xml->SetFileName(fileName.c_str());
+		reader = xml.GetPointer();
+	}
+	else if (EndsWith(fileName, ".mhd") || EndsWith(fileName, ".mha"))
+	{
+		vtkSmartPointer<vtkMetaImageReader> meta = vtkSmartPointer<vtkMetaImageReader>::New();
+		meta->SetFileName(fileName.c_str());
+		reader = meta.GetPointer();
+	}
+	else if (EndsWith(fileName, ".nii") || EndsWith(fileName, ".nii.gz"))
+	{
+		vtkSmartPointer<vtkNIFTIImageReader> nifti = vtkSmartPointer<vtkNIFTIImageReader>::New();
+		nifti->SetFileName(fileName.c_str());
+		reader = nifti.GetPointer();
+	}
+	else
+	{
+		vtkSmartPointer<vtkImageReader2Factory> factory = vtkSmartPointer<vtkImageReader2Factory>::New();
+		vtkSmartPointer<vtkImageReader2> image;
+		image.TakeReference(factory->CreateImageReader2(fileName.c_str()));
+		if (!image)
+		{
+			return nullptr;
+		}
+		image->SetFileName(fileName.c_str());
+		reader = image.GetPointer();
+	}
+
+	reader->Update();
+	vtkImageData *output = vtkImageData::SafeDownCast(reader->GetOutputDataObject(0));
+	if (!output || output->GetNumberOfPoints() == 0 || !output->GetPointData()->GetScalars())
+	{
+		return nullptr;
+	}
+	vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+	image->ShallowCopy(output);
+	return image;
+}
+
+// Parse a number field, surrounding spaces allowed
+template <class T>
+static bool ParseField(const std::string &field, T &value)
+{
+	std::istringstream stream(field);
+	return (stream >> value) && (stream >> std::ws).eof();
+}
+
+// Parse the ROI file into studies, in order of first appearance of the images
+static bool ReadROIs(const char *fileName, std::vector<Study> &studies)
+{
+	std::ifstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+	std::map<std::string, size_t> index;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		// The image is the whole first field, so that its path may contain
+		// spaces
+		std::istringstream fields(line);
+		std::string image, token[5];
+		ROI roi;
+		bool valid = static_cast<bool>(std::getline(fields, image, ','));
+		for (int k = 0; k < 5 && valid; k++)
+		{
+			valid = static_cast<bool>(std::getline(fields, token[k], ','));
+		}
+		if (!valid || image.empty() ||
+			!ParseField(token[0], roi.Slice) ||
+			!ParseField(token[1], roi.Center[0]) || !ParseField(token[2], roi.Center[1]) ||
+			!ParseField(token[3], roi.Radius[0]) || !ParseField(token[4], roi.Radius[1]))
+		{
+			if (lineNumber > 1)
+			{
+				std::cerr << fileName << ":" << lineNumber << ": ignoring malformed line\n";
+			}
+			continue;
+		}
+		auto found = index.find(image);
+		if (found == index.end())
+		{
+			found = index.insert(std::make_pair(image, studies.size())).first;
+			studies.push_back(Study());
+			studies.back().FileName = image;
+		}
+		studies[found->second].ROIs.push_back(roi);
+	}
+	return true;
+}
+
+// Peak resident set size in bytes
+static double PeakRSS()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return static_cast<double>(counters.PeakWorkingSetSize);
+	}
+	return 0.0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return static_cast<double>(usage.ru_maxrss);
+#else
+	return 1024.0 * usage.ru_maxrss;
+#endif
+#endif
+}
+
+static void Usage(const char *program)
+{
+	std::cerr << "Usage: " << program << " rois.csv [-o output.csv] [--prefetch N]"
+		<< " [--threads N] [--partial-volume] [--reproducible]\n";
+}
+
+int main(int argc, char *argv[])
+{
+	const char *roiFileName = nullptr;
+	const char *outputFileName = nullptr;
+	int prefetch = 2;
+	int threads = 0;
+	bool partialVolume = false;
+	bool reproducible = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+		{
+			outputFileName = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--prefetch") && i + 1 < argc)
+		{
+			prefetch = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--partial-volume"))
+		{
+			partialVolume = true;
+		}
+		else if (!strcmp(argv[i], "--reproducible"))
+		{
+			reproducible = true;
+		}
+		else if (!roiFileName && argv[i][0] != '-')
+		{
+			roiFileName = argv[i];
+		}
+		else
+		{
+			Usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (!roiFileName)
+	{
+		Usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Study> studies;
+	if (!ReadROIs(roiFileName, studies))
+	{
+		std::cerr << "Cannot read " << roiFileName << "\n";
+		return EXIT_FAILURE;
+	}
+
+	std::ofstream outputFile;
+	if (outputFileName)
+	{
+		outputFile.open(outputFileName);
+		if (!outputFile)
+		{
+			std::cerr << "Cannot write " << outputFileName << "\n";
+			return EXIT_FAILURE;
+		}
+	}
+	std::ostream &output = outputFileName ? outputFile : std::cout;
+	output.precision(10);
+	output << "image,slice,cx,cy,rx,ry,count,area,mean,stddev,min,max\n";
+
+	if (threads > 0)
+	{
+		vtkSMPTools::Initialize(threads);
+	}
+
+	// The reader thread loads the studies ahead of the computation
+	auto start = std::chrono::steady_clock::now();
+	StudyQueue queue(static_cast<size_t>(std::max(prefetch, 1)));
+	std::thread reader([&studies, &queue]()
+	{
+		for (Study &study : studies)
+		{
+			study.Image = ReadImage(study.FileName);
+			queue.Push(&study);
+		}
+		queue.Close();
+	});
+
+	// The statistics are computed in parallel over the rows of each ROI
+	vtkSmartPointer<vtkEllipseStatistics> stats = vtkSmartPointer<vtkEllipseStatistics>::New();
+	stats->SetBoundaryMode(partialVolume ? vtkEllipseStatistics::PARTIAL_VOLUME :
+		vtkEllipseStatistics::BINARY);
+	stats->SetReproducible(reproducible);
+	int failures = 0;
+	size_t numberOfStudies = 0, numberOfROIs = 0;
+	double numberOfVoxels = 0.0, numberOfMeasuredVoxels = 0.0;
+	while (Study *study = queue.Pop())
+	{
+		if (!study->Image)
+		{
+			std::cerr << "Cannot read image " << study->FileName << "\n";
+			failures++;
+			continue;
+		}
+		numberOfStudies++;
+		numberOfVoxels += static_cast<double>(study->Image->GetNumberOfPoints());
+
+		stats->SetInputData(study->Image);
+		for (const ROI &roi : study->ROIs)
+		{
+			stats->SetSlice(roi.Slice);
+			stats->SetCenter(roi.Center[0], roi.Center[1]);
+			stats->SetRadius(roi.Radius[0], roi.Radius[1]);
+			stats->Update();
+			output << study->FileName << "," << roi.Slice << ","
+				<< roi.Center[0] << "," << roi.Center[1] << ","
+				<< roi.Radius[0] << "," << roi.Radius[1] << ","
+				<< stats->GetCount() << "," << stats->GetArea() << ","
+				<< stats->GetMean() << "," << stats->GetStandardDeviation() << ","
+				<< stats->GetMinimum() << "," << stats->GetMaximum() << "\n";
+			numberOfROIs++;
+			numberOfMeasuredVoxels += stats->GetCount();
+		}
+
+		// Release the image as soon as it is measured
+		stats->SetInputData(nullptr);
+		study->Image = nullptr;
+	}
+	reader.join();
+
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	seconds = std::max(seconds, 1e-9);
+	std::cerr << numberOfStudies << " studies, " << numberOfROIs << " ROIs in "
+		<< seconds << " s\n"
+		<< numberOfVoxels << " voxels loaded, " << numberOfVoxels / seconds << " voxels/s\n"
+		<< numberOfMeasuredVoxels << " voxels measured in the ROIs, "
+		<< numberOfMeasuredVoxels / seconds << " voxels/s\n"
+		<< numberOfStudies / seconds << " studies/s\n"
+		<< "peak RSS " << PeakRSS() / (1024.0 * 1024.0) << " MiB\n";
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
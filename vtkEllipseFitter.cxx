@@ -0,0 +1,495 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseFitter.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseFitter.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+
+vtkStandardNewMacro(vtkEllipseFitter);
+
+//-------------------------------------------------------------------------
+// Central moments of one label: number of samples, centroid and the
+// second central moments xx, yy and xy. Merged with Chan's formulas.
+struct vtkEllipseFitterCentralMoments
+{
+	double N = 0.0;
+	double Mean[2] = { 0.0, 0.0 };
+	double C[3] = { 0.0, 0.0, 0.0 };
+
+	void Merge(const vtkEllipseFitterCentralMoments &other)
+	{
+		double n = this->N + other.N;
+		if (other.N <= 0.0)
+		{
+			return;
+		}
+		double dx = other.Mean[0] - this->Mean[0];
+		double dy = other.Mean[1] - this->Mean[1];
+		double f = this->N * other.N / n;
+		this->Mean[0] += dx * other.N / n;
+		this->Mean[1] += dy * other.N / n;
+		this->C[0] += other.C[0] + dx * dx * f;
+		this->C[1] += other.C[1] + dy * dy * f;
+		this->C[2] += other.C[2] + dx * dy * f;
+		this->N = n;
+	}
+};
+
+// Raw moments of one label gathered by one thread, relative to the first
+// sample met so that the sums stay small
+struct vtkEllipseFitterMoments
+{
+	double N = 0.0;
+	double Ref[2] = { 0.0, 0.0 };
+	double S[2] = { 0.0, 0.0 };
+	double SS[3] = { 0.0, 0.0, 0.0 };
+
+	// Add the samples x = i0..i1 of row y in closed form
+	void AddRun(double i0, double i1, double y)
+	{
+		if (this->N == 0.0)
+		{
+			this->Ref[0] = i0;
+			this->Ref[1] = y;
+		}
+		double a = i0 - this->Ref[0];
+		double b = i1 - this->Ref[0];
+		double v = y - this->Ref[1];
+		double m = b - a + 1.0;
+		double c = 0.5 * (a + b);
+		double sx = m * c;
+		this->N += m;
+		this->S[0] += sx;
+		this->S[1] += m * v;
+		this->SS[0] += m * c * c + m * (m * m - 1.0) / 12.0;
+		this->SS[1] += m * v * v;
+		this->SS[2] += sx * v;
+	}
+
+	void AddPoint(double x, double y)
+	{
+		if (this->N == 0.0)
+		{
+			this->Ref[0] = x;
+			this->Ref[1] = y;
+		}
+		double u = x - this->Ref[0];
+		double v = y - this->Ref[1];
+		this->N += 1.0;
+		this->S[0] += u;
+		this->S[1] += v;
+		this->SS[0] += u * u;
+		this->SS[1] += v * v;
+		this->SS[2] += u * v;
+	}
+
+	vtkEllipseFitterCentralMoments GetCentral() const
+	{
+		vtkEllipseFitterCentralMoments central;
+		central.N = this->N;
+		double mu = this->S[0] / this->N;
+		double mv = this->S[1] / this->N;
+		central.Mean[0] = this->Ref[0] + mu;
+		central.Mean[1] = this->Ref[1] + mv;
+		central.C[0] = std::max(this->SS[0] - this->N * mu * mu, 0.0);
+		central.C[1] = std::max(this->SS[1] - this->N * mv * mv, 0.0);
+		central.C[2] = this->SS[2] - this->N * mu * mv;
+		return central;
+	}
+};
+
+typedef std::unordered_map<vtkIdType, vtkEllipseFitterMoments> vtkEllipseFitterMomentsMap;
+typedef std::map<vtkIdType, vtkEllipseFitterCentralMoments> vtkEllipseFitterResultMap;
+
+//-------------------------------------------------------------------------
+// Traverse the rows of a label slice as runs of equal labels
+template <class T>
+class vtkEllipseFitterImageFunctor
+{
+public:
+	const T *Base;
+	vtkIdType Increments[2];
+	int Extent[4];
+	vtkSMPThreadLocal<vtkEllipseFitterMomentsMap> Moments;
+
+	void Initialize()
+	{
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		vtkEllipseFitterMomentsMap &moments = this->Moments.Local();
+		const int width = this->Extent[1] - this->Extent[0] + 1;
+		for (vtkIdType j = begin; j < end; j++)
+		{
+			const T *row = this->Base + (j - this->Extent[2]) * this->Increments[1];
+			int runStart = 0;
+			vtkIdType runLabel = static_cast<vtkIdType>(row[0]);
+			for (int i = 1; i <= width; i++)
+			{
+				vtkIdType label = (i < width ?
+					static_cast<vtkIdType>(row[i * this->Increments[0]]) : runLabel - 1);
+				if (label == runLabel)
+				{
+					continue;
+				}
+				if (runLabel > 0)
+				{
+					moments[runLabel].AddRun(this->Extent[0] + runStart,
+						this->Extent[0] + i - 1, static_cast<double>(j));
+				}
+				runStart = i;
+				runLabel = label;
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+//-------------------------------------------------------------------------
+class vtkEllipseFitterPointsFunctor
+{
+public:
+	vtkPoints *Points;
+	vtkDataArray *Labels;
+	vtkSMPThreadLocal<vtkEllipseFitterMomentsMap> Moments;
+	vtkSMPThreadLocal<double> SumZ;
+
+	void Initialize()
+	{
+		this->SumZ.Local() = 0.0;
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		vtkEllipseFitterMomentsMap &moments = this->Moments.Local();
+		double &sumZ = this->SumZ.Local();
+		double x[3];
+		for (vtkIdType id = begin; id < end; id++)
+		{
+			this->Points->GetPoint(id, x);
+			vtkIdType label = this->Labels ?
+				static_cast<vtkIdType>(this->Labels->GetComponent(id, 0)) : 0;
+			moments[label].AddPoint(x[0], x[1]);
+			sumZ += x[2];
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+//-------------------------------------------------------------------------
+static void vtkEllipseFitterMerge(vtkSMPThreadLocal<vtkEllipseFitterMomentsMap> &moments,
+	vtkEllipseFitterResultMap &result)
+{
+	for (auto it = moments.begin(); it != moments.end(); ++it)
+	{
+		for (const auto &entry : *it)
+		{
+			result[entry.first].Merge(entry.second.GetCentral());
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseFitterExecute(const T *base, const vtkIdType increments[2],
+	const int extent[4], vtkEllipseFitterResultMap &result)
+{
+	vtkEllipseFitterImageFunctor<T> functor;
+	functor.Base = base;
+	functor.Increments[0] = increments[0];
+	functor.Increments[1] = increments[1];
+	std::copy(extent, extent + 4, functor.Extent);
+	vtkSMPTools::For(extent[2], extent[3] + 1, functor);
+	vtkEllipseFitterMerge(functor.Moments, result);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseFitter::vtkEllipseFitter()
+{
+	this->Input = nullptr;
+	this->Slice = 0;
+	this->InputPoints = nullptr;
+	this->PointLabels = nullptr;
+	this->PointDistribution = REGION;
+	this->PlaneZ = 0.0;
+
+	this->Labels = vtkIdTypeArray::New();
+	this->Labels->SetName("Label");
+	this->Counts = vtkIdTypeArray::New();
+	this->Counts->SetName("Count");
+	this->Parameters = vtkDoubleArray::New();
+	this->Parameters->SetName("EllipseParameters");
+	this->Parameters->SetNumberOfComponents(4);
+	this->Orientations = vtkDoubleArray::New();
+	this->Orientations->SetName("Orientation");
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseFitter::~vtkEllipseFitter()
+{
+	this->SetInputData(nullptr);
+	this->SetInputPoints(nullptr);
+	this->SetPointLabels(nullptr);
+	this->Labels->Delete();
+	this->Counts->Delete();
+	this->Parameters->Delete();
+	this->Orientations->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::SetInputData(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::SetInputPoints(vtkPoints *points)
+{
+	vtkSetObjectBodyMacro(InputPoints, vtkPoints, points);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::SetPointLabels(vtkDataArray *labels)
+{
+	vtkSetObjectBodyMacro(PointLabels, vtkDataArray, labels);
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseFitter::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Input)
+	{
+		mTime = std::max(mTime, this->Input->GetMTime());
+	}
+	if (this->InputPoints)
+	{
+		mTime = std::max(mTime, this->InputPoints->GetMTime());
+	}
+	if (this->PointLabels)
+	{
+		mTime = std::max(mTime, this->PointLabels->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		this->Compute();
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkIdType vtkEllipseFitter::GetNumberOfEllipses()
+{
+	return this->Parameters->GetNumberOfTuples();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::Compute()
+{
+	this->Labels->Reset();
+	this->Counts->Reset();
+	this->Parameters->Reset();
+	this->Orientations->Reset();
+
+	if (this->Input)
+	{
+		this->FitImage();
+	}
+	else if (this->InputPoints)
+	{
+		this->FitPoints();
+	}
+	else
+	{
+		vtkErrorMacro(<< "No label image or points to fit");
+	}
+
+	this->Labels->Modified();
+	this->Counts->Modified();
+	this->Parameters->Modified();
+	this->Orientations->Modified();
+}
+
+//-------------------------------------------------------------------------
+// Turn merged central moments into ellipses. scale maps index to world
+// units, pixelVariance is the variance of one sample along each axis, and
+// factor converts a standard deviation into a semi-axis length.
+static void vtkEllipseFitterFinalize(const vtkEllipseFitterResultMap &result,
+	const double origin[2], const double scale[2], const double pixelVariance[2],
+	double factor, vtkIdTypeArray *labels, vtkIdTypeArray *counts,
+	vtkDoubleArray *parameters, vtkDoubleArray *orientations)
+{
+	vtkIdType n = static_cast<vtkIdType>(result.size());
+	labels->SetNumberOfTuples(n);
+	counts->SetNumberOfTuples(n);
+	parameters->SetNumberOfTuples(n);
+	orientations->SetNumberOfTuples(n);
+
+	vtkIdType i = 0;
+	for (const auto &entry : result)
+	{
+		const vtkEllipseFitterCentralMoments &m = entry.second;
+		double varX = scale[0] * scale[0] * m.C[0] / m.N + pixelVariance[0];
+		double varY = scale[1] * scale[1] * m.C[1] / m.N + pixelVariance[1];
+		double covXY = scale[0] * scale[1] * m.C[2] / m.N;
+
+		double p[4] = {
+			origin[0] + scale[0] * m.Mean[0],
+			origin[1] + scale[1] * m.Mean[1],
+			factor * sqrt(varX),
+			factor * sqrt(varY) };
+		labels->SetValue(i, entry.first);
+		counts->SetValue(i, static_cast<vtkIdType>(m.N));
+		parameters->SetTypedTuple(i, p);
+		orientations->SetValue(i,
+			vtkMath::DegreesFromRadians(0.5 * atan2(2.0 * covXY, varX - varY)));
+		i++;
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::FitImage()
+{
+	vtkDataArray *scalars = this->Input->GetPointData()->GetScalars();
+	if (!scalars)
+	{
+		vtkErrorMacro(<< "The label image has no scalars");
+		return;
+	}
+	int extent[6];
+	this->Input->GetExtent(extent);
+	if (this->Slice < extent[4] || this->Slice > extent[5])
+	{
+		vtkErrorMacro(<< "Slice " << this->Slice << " is outside of the input extent");
+		return;
+	}
+
+	vtkIdType increments[3];
+	this->Input->GetIncrements(increments);
+	void *base = this->Input->GetScalarPointer(extent[0], extent[2], this->Slice);
+
+	vtkEllipseFitterResultMap result;
+	switch (scalars->GetDataType())
+	{
+		vtkTemplateMacro(vtkEllipseFitterExecute(
+			static_cast<const VTK_TT*>(base), increments, extent, result));
+	default:
+		vtkErrorMacro(<< "Unsupported label type");
+		return;
+	}
+
+	// A pixel is a uniform sample of its square: add its own variance
+	double origin[3], spacing[3];
+	this->Input->GetOrigin(origin);
+	this->Input->GetSpacing(spacing);
+	this->PlaneZ = origin[2] + spacing[2] * this->Slice;
+	double pixelVariance[2] = {
+		spacing[0] * spacing[0] / 12.0,
+		spacing[1] * spacing[1] / 12.0 };
+	vtkEllipseFitterFinalize(result, origin, spacing, pixelVariance, 2.0,
+		this->Labels, this->Counts, this->Parameters, this->Orientations);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::FitPoints()
+{
+	vtkIdType numPts = this->InputPoints->GetNumberOfPoints();
+	if (this->PointLabels && this->PointLabels->GetNumberOfTuples() < numPts)
+	{
+		vtkErrorMacro(<< "There are fewer point labels than points");
+		return;
+	}
+	if (numPts == 0)
+	{
+		return;
+	}
+
+	vtkEllipseFitterPointsFunctor functor;
+	functor.Points = this->InputPoints;
+	functor.Labels = this->PointLabels;
+	vtkSMPTools::For(0, numPts, functor);
+
+	vtkEllipseFitterResultMap result;
+	vtkEllipseFitterMerge(functor.Moments, result);
+	double sumZ = 0.0;
+	for (auto it = functor.SumZ.begin(); it != functor.SumZ.end(); ++it)
+	{
+		sumZ += *it;
+	}
+	this->PlaneZ = sumZ / numPts;
+
+	// Uniform samples of a filled ellipse have a variance of r^2/4 along an
+	// axis, samples of its contour a variance of r^2/2
+	double origin[2] = { 0.0, 0.0 };
+	double scale[2] = { 1.0, 1.0 };
+	double pixelVariance[2] = { 0.0, 0.0 };
+	double factor = (this->PointDistribution == CONTOUR ? sqrt(2.0) : 2.0);
+	vtkEllipseFitterFinalize(result, origin, scale, pixelVariance, factor,
+		this->Labels, this->Counts, this->Parameters, this->Orientations);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseRepresentation *vtkEllipseFitter::NewRepresentation(vtkIdType i)
+{
+	if (i < 0 || i >= this->Parameters->GetNumberOfTuples())
+	{
+		vtkErrorMacro(<< "No fitted ellipse " << i);
+		return nullptr;
+	}
+	double p[4];
+	this->Parameters->GetTypedTuple(i, p);
+
+	vtkEllipseRepresentation *rep = vtkEllipseRepresentation::New();
+	rep->SetAnchorModeToWorld();
+	rep->GetPositionCoordinate()->SetValue(p[0] - p[2], p[1] - p[3], this->PlaneZ);
+	rep->GetPosition2Coordinate()->SetValue(p[0] + p[2], p[1] + p[3], this->PlaneZ);
+	return rep;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseFitter::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Input Points: " << this->InputPoints << "\n";
+	os << indent << "Point Labels: " << this->PointLabels << "\n";
+	os << indent << "Point Distribution: "
+		<< (this->PointDistribution == CONTOUR ? "Contour\n" : "Region\n");
+	os << indent << "Number Of Ellipses: " << this->Parameters->GetNumberOfTuples() << "\n";
+}
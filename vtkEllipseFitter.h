@@ -0,0 +1,162 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseFitter.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseFitter
+* @brief   fit one ellipse ROI per label of a label image or point set
+*
+* vtkEllipseFitter creates ellipse ROIs from existing segmentations. The
+* input is either a slice of a label image (every positive label is one
+* component, 0 and negative values are background) or a set of points with
+* an optional label per point. One axis aligned ellipse is fitted to every
+* label from its moments: the center is the centroid and the semi-axes are
+* derived from the second central moments along x and y, assuming the
+* samples cover the area of the region (REGION) or lie on its contour
+* (CONTOUR). The orientation of the principal axis is reported as well.
+*
+* All the labels are fitted in a single parallel pass over the data. Each
+* thread accumulates the moments of the labels it meets; label images are
+* traversed as runs of equal labels whose moments are added in closed form,
+* so the cost is dominated by one linear scan of the image.
+*
+* The fitted ellipses are returned as a batch of parameters (center x,
+* center y, semi-axis x, semi-axis y, in world coordinates), sorted by
+* label, which can be fed to vtkEllipseOverlapAnalysis, or turned into world
+* anchored representations with NewRepresentation().
+*
+* @sa
+* vtkEllipseRepresentation vtkEllipseOverlapAnalysis
+*/
+
+#ifndef vtkEllipseFitter_h
+#define vtkEllipseFitter_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkImageData;
+class vtkPoints;
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkIdTypeArray;
+class vtkEllipseRepresentation;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseFitter : public vtkObject
+class vtkEllipseFitter : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseFitter *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseFitter, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify a label image to fit. The labels are read from the first
+	* component of the scalars of the slice Slice (a k index in extent
+	* coordinates). The label image takes precedence over the points.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	//@}
+
+	//@{
+	/**
+	* Specify a point set to fit, and optionally the label of each point.
+	* Without labels, a single ellipse (label 0) is fitted to all the points.
+	*/
+	virtual void SetInputPoints(vtkPoints *points);
+	vtkGetObjectMacro(InputPoints, vtkPoints);
+	virtual void SetPointLabels(vtkDataArray *labels);
+	vtkGetObjectMacro(PointLabels, vtkDataArray);
+	//@}
+
+	enum { REGION = 0, CONTOUR };
+
+	//@{
+	/**
+	* Specify whether the input points sample the area of the regions
+	* (REGION, the default) or their contour (CONTOUR). Label images are always
+	* fitted as regions.
+	*/
+	vtkSetClampMacro(PointDistribution, int, REGION, CONTOUR);
+	vtkGetMacro(PointDistribution, int);
+	void SetPointDistributionToRegion() { this->SetPointDistribution(REGION); }
+	void SetPointDistributionToContour() { this->SetPointDistribution(CONTOUR); }
+	//@}
+
+	/**
+	* Fit the ellipses if the input or the parameters changed since the last
+	* update.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* Results of the last update, one tuple per fitted label, sorted by label:
+	* the label, the number of samples, the ellipse parameters (center x,
+	* center y, semi-axis x, semi-axis y) and the orientation in degrees of
+	* the principal axis of the label with respect to the x axis.
+	*/
+	vtkGetObjectMacro(Labels, vtkIdTypeArray);
+	vtkGetObjectMacro(Counts, vtkIdTypeArray);
+	vtkGetObjectMacro(Parameters, vtkDoubleArray);
+	vtkGetObjectMacro(Orientations, vtkDoubleArray);
+	vtkIdType GetNumberOfEllipses();
+	//@}
+
+	/**
+	* Create a world anchored representation of the i-th fitted ellipse. The
+	* caller owns the returned object.
+	*/
+	vtkEllipseRepresentation *NewRepresentation(vtkIdType i);
+
+	/**
+	* Return the MTime also considering the inputs.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipseFitter();
+	~vtkEllipseFitter() override;
+
+	vtkImageData *Input;
+	int Slice;
+	vtkPoints *InputPoints;
+	vtkDataArray *PointLabels;
+	int PointDistribution;
+
+	vtkIdTypeArray *Labels;
+	vtkIdTypeArray *Counts;
+	vtkDoubleArray *Parameters;
+	vtkDoubleArray *Orientations;
+	double PlaneZ;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+	void FitImage();
+	void FitPoints();
+
+private:
+	vtkEllipseFitter(const vtkEllipseFitter&) = delete;
+	void operator=(const vtkEllipseFitter&) = delete;
+};
+
+#endif
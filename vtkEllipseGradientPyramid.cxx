@@ -0,0 +1,438 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseGradientPyramid.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseGradientPyramid.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkSMPTools.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseGradientPyramid);
+
+namespace
+{
+// One level of the pyramid. Pixel (i, j) averages Scale x Scale pixels of
+// the slice, starting at pixel (i * Scale, j * Scale) of the extent.
+struct vtkEllipseGradientLevel
+{
+	int Size[2];
+	int Scale;
+	std::vector<float> Magnitude;
+
+	// Bilinear interpolation at the continuous index (u, v) of the level
+	double Sample(double u, double v) const
+	{
+		if (u < 0.0 || v < 0.0 || u > this->Size[0] - 1 || v > this->Size[1] - 1)
+		{
+			return 0.0;
+		}
+		int i = std::min(static_cast<int>(u), std::max(this->Size[0] - 2, 0));
+		int j = std::min(static_cast<int>(v), std::max(this->Size[1] - 2, 0));
+		double s = u - i;
+		double t = v - j;
+		int di = (this->Size[0] > 1 ? 1 : 0);
+		int dj = (this->Size[1] > 1 ? this->Size[0] : 0);
+		const float *p = this->Magnitude.data() + j * this->Size[0] + i;
+		double a = p[0] + s * (p[di] - p[0]);
+		double b = p[dj] + s * (p[dj + di] - p[dj]);
+		return a + t * (b - a);
+	}
+};
+
+struct vtkEllipseGradientSlice
+{
+	int Slice;
+	std::vector<vtkEllipseGradientLevel> Levels;
+};
+
+// Central differences (one sided on the borders) of the rows of a level,
+// in intensity per world unit
+class vtkEllipseGradientFunctor
+{
+public:
+	const float *Intensity;
+	float *Magnitude;
+	int Size[2];
+	double Step[2]; // world size of a pixel of the level
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		const int nx = this->Size[0];
+		const int ny = this->Size[1];
+		for (vtkIdType jj = begin; jj < end; jj++)
+		{
+			int j = static_cast<int>(jj);
+			int j0 = std::max(j - 1, 0);
+			int j1 = std::min(j + 1, ny - 1);
+			double dy = (j1 - j0) * this->Step[1];
+			const float *row = this->Intensity + j * nx;
+			for (int i = 0; i < nx; i++)
+			{
+				int i0 = std::max(i - 1, 0);
+				int i1 = std::min(i + 1, nx - 1);
+				double gx = (i1 > i0) ? (row[i1] - row[i0]) / ((i1 - i0) * this->Step[0]) : 0.0;
+				double gy = (j1 > j0) ?
+					(this->Intensity[j1 * nx + i] - this->Intensity[j0 * nx + i]) / dy : 0.0;
+				this->Magnitude[j * nx + i] = static_cast<float>(sqrt(gx * gx + gy * gy));
+			}
+		}
+	}
+};
+
+template <class T>
+void vtkEllipseGradientPyramidCopy(const T *base, vtkIdType increments[3], int nx, int ny,
+	float *intensity)
+{
+	for (int j = 0; j < ny; j++)
+	{
+		const T *p = base + j * increments[1];
+		for (int i = 0; i < nx; i++, p += increments[0])
+		{
+			*intensity++ = static_cast<float>(*p);
+		}
+	}
+}
+}
+
+//-------------------------------------------------------------------------
+// The slices are kept from the most to the least recently used
+class vtkEllipseGradientPyramid::vtkInternals
+{
+public:
+	std::list<vtkEllipseGradientSlice> Slices;
+	vtkImageData *Image = nullptr;
+	vtkMTimeType ImageMTime = 0;
+
+	// Geometry of the image when the slices were computed
+	int Extent[6];
+	double Origin[3];
+	double Spacing[3];
+
+	// World position (x, y) to continuous index of a level
+	void ToLevel(const vtkEllipseGradientLevel &level, double x, double y,
+		double &u, double &v) const
+	{
+		double s = level.Scale;
+		u = ((x - this->Origin[0]) / this->Spacing[0] - this->Extent[0] - 0.5 * (s - 1.0)) / s;
+		v = ((y - this->Origin[1]) / this->Spacing[1] - this->Extent[2] - 0.5 * (s - 1.0)) / s;
+	}
+
+	double Contour(const vtkEllipseGradientLevel &level, const double center[2],
+		const double radius[2]) const
+	{
+		// About one sample per pixel of the level along the perimeter
+		double pixel = std::min(fabs(this->Spacing[0]), fabs(this->Spacing[1])) * level.Scale;
+		double perimeter = 2.0 * vtkMath::Pi() *
+			sqrt(0.5 * (radius[0] * radius[0] + radius[1] * radius[1]));
+		int n = std::min(std::max(static_cast<int>(perimeter / pixel), 16), 512);
+
+		double sum = 0.0;
+		for (int k = 0; k < n; k++)
+		{
+			double angle = 2.0 * vtkMath::Pi() * k / n;
+			double u, v;
+			this->ToLevel(level, center[0] + radius[0] * cos(angle),
+				center[1] + radius[1] * sin(angle), u, v);
+			sum += level.Sample(u, v);
+		}
+		return sum / n;
+	}
+};
+
+//-------------------------------------------------------------------------
+vtkEllipseGradientPyramid::vtkEllipseGradientPyramid()
+{
+	this->Input = nullptr;
+	this->Slice = 0;
+	this->Component = 0;
+	this->NumberOfLevels = 4;
+	this->MaximumNumberOfSlices = 8;
+	this->SearchRange = 0.25;
+	this->Internals = new vtkInternals;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseGradientPyramid::~vtkEllipseGradientPyramid()
+{
+	this->SetInputData(nullptr);
+	delete this->Internals;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseGradientPyramid::SetInputData(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseGradientPyramid::SetComponent(int component)
+{
+	component = std::max(component, 0);
+	if (component != this->Component)
+	{
+		this->Component = component;
+		this->Initialize();
+		this->Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseGradientPyramid::SetNumberOfLevels(int levels)
+{
+	levels = std::min(std::max(levels, 1), 16);
+	if (levels != this->NumberOfLevels)
+	{
+		this->NumberOfLevels = levels;
+		this->Initialize();
+		this->Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseGradientPyramid::Initialize()
+{
+	this->Internals->Slices.clear();
+	this->Internals->Image = nullptr;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseGradientPyramid::GetNumberOfCachedSlices()
+{
+	return static_cast<int>(this->Internals->Slices.size());
+}
+
+//-------------------------------------------------------------------------
+bool vtkEllipseGradientPyramid::Prepare()
+{
+	vtkDataArray *scalars = this->Input ? this->Input->GetPointData()->GetScalars() : nullptr;
+	if (!scalars || this->Component >= scalars->GetNumberOfComponents())
+	{
+		return false;
+	}
+
+	// A modified image invalidates all the slices
+	vtkInternals *internals = this->Internals;
+	if (internals->Image != this->Input || internals->ImageMTime != this->Input->GetMTime())
+	{
+		internals->Slices.clear();
+		internals->Image = this->Input;
+		internals->ImageMTime = this->Input->GetMTime();
+		this->Input->GetExtent(internals->Extent);
+		this->Input->GetOrigin(internals->Origin);
+		this->Input->GetSpacing(internals->Spacing);
+	}
+	const int *extent = internals->Extent;
+	if (this->Slice < extent[4] || this->Slice > extent[5])
+	{
+		return false;
+	}
+
+	for (auto it = internals->Slices.begin(); it != internals->Slices.end(); ++it)
+	{
+		if (it->Slice == this->Slice)
+		{
+			internals->Slices.splice(internals->Slices.begin(), internals->Slices, it);
+			return true;
+		}
+	}
+
+	// Copy the component of the slice, then compute the gradient of each
+	// level and average it down into the next
+	int nx = extent[1] - extent[0] + 1;
+	int ny = extent[3] - extent[2] + 1;
+	std::vector<float> intensity(static_cast<size_t>(nx) * ny);
+	vtkIdType increments[3];
+	this->Input->GetIncrements(increments);
+	void *base = this->Input->GetScalarPointer(extent[0], extent[2], this->Slice);
+	switch (scalars->GetDataType())
+	{
+		vtkTemplateMacro(vtkEllipseGradientPyramidCopy(
+			static_cast<const VTK_TT*>(base) + this->Component, increments, nx, ny,
+			intensity.data()));
+	default:
+		vtkErrorMacro(<< "Unsupported scalar type");
+		return false;
+	}
+
+	vtkEllipseGradientSlice slice;
+	slice.Slice = this->Slice;
+	int scale = 1;
+	for (int l = 0; l < this->NumberOfLevels; l++)
+	{
+		vtkEllipseGradientLevel level;
+		level.Size[0] = nx;
+		level.Size[1] = ny;
+		level.Scale = scale;
+		level.Magnitude.resize(intensity.size());
+
+		vtkEllipseGradientFunctor functor;
+		functor.Intensity = intensity.data();
+		functor.Magnitude = level.Magnitude.data();
+		functor.Size[0] = nx;
+		functor.Size[1] = ny;
+		functor.Step[0] = fabs(internals->Spacing[0]) * scale;
+		functor.Step[1] = fabs(internals->Spacing[1]) * scale;
+		vtkSMPTools::For(0, ny, functor);
+		slice.Levels.push_back(std::move(level));
+
+		if (nx < 4 || ny < 4)
+		{
+			break;
+		}
+		int mx = (nx + 1) / 2;
+		int my = (ny + 1) / 2;
+		std::vector<float> coarse(static_cast<size_t>(mx) * my);
+		for (int j = 0; j < my; j++)
+		{
+			int j0 = 2 * j;
+			int j1 = std::min(2 * j + 1, ny - 1);
+			for (int i = 0; i < mx; i++)
+			{
+				int i0 = 2 * i;
+				int i1 = std::min(2 * i + 1, nx - 1);
+				coarse[j * mx + i] = 0.25f * (intensity[j0 * nx + i0] + intensity[j0 * nx + i1] +
+					intensity[j1 * nx + i0] + intensity[j1 * nx + i1]);
+			}
+		}
+		intensity.swap(coarse);
+		nx = mx;
+		ny = my;
+		scale *= 2;
+	}
+
+	internals->Slices.push_front(std::move(slice));
+	while (static_cast<int>(internals->Slices.size()) > this->MaximumNumberOfSlices)
+	{
+		internals->Slices.pop_back();
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseGradientPyramid::Sample(int level, double x, double y)
+{
+	if (!this->Prepare())
+	{
+		return 0.0;
+	}
+	const std::vector<vtkEllipseGradientLevel> &levels = this->Internals->Slices.front().Levels;
+	if (level < 0 || level >= static_cast<int>(levels.size()))
+	{
+		return 0.0;
+	}
+	double u, v;
+	this->Internals->ToLevel(levels[level], x, y, u, v);
+	return levels[level].Sample(u, v);
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseGradientPyramid::EvaluateContour(int level, const double center[2],
+	const double radius[2])
+{
+	if (!this->Prepare())
+	{
+		return 0.0;
+	}
+	const std::vector<vtkEllipseGradientLevel> &levels = this->Internals->Slices.front().Levels;
+	if (level < 0 || level >= static_cast<int>(levels.size()))
+	{
+		return 0.0;
+	}
+	return this->Internals->Contour(levels[level], center, radius);
+}
+
+//-------------------------------------------------------------------------
+bool vtkEllipseGradientPyramid::RefineEllipse(double center[2], double radius[2])
+{
+	if (!this->Prepare() || radius[0] <= 0.0 || radius[1] <= 0.0)
+	{
+		return false;
+	}
+	const vtkInternals *internals = this->Internals;
+	const std::vector<vtkEllipseGradientLevel> &levels = internals->Slices.front().Levels;
+
+	// The parameters (cx, cy, rx, ry) and the box they are searched in
+	double p[4] = { center[0], center[1], radius[0], radius[1] };
+	double spacing[2] = { fabs(internals->Spacing[0]), fabs(internals->Spacing[1]) };
+	double lo[4], hi[4];
+	for (int a = 0; a < 2; a++)
+	{
+		double range = this->SearchRange * radius[a];
+		lo[a] = center[a] - range;
+		hi[a] = center[a] + range;
+		lo[a + 2] = std::max(radius[a] - range, spacing[a]);
+		hi[a + 2] = std::max(radius[a] + range, lo[a + 2]);
+	}
+
+	// Pattern search with steps of one pixel of each level, coarse to fine.
+	// The best contour of a level is the start of the next one.
+	for (int l = static_cast<int>(levels.size()) - 1; l >= 0; l--)
+	{
+		const vtkEllipseGradientLevel &level = levels[l];
+		double step[4] = {
+			spacing[0] * level.Scale, spacing[1] * level.Scale,
+			spacing[0] * level.Scale, spacing[1] * level.Scale };
+		double best = internals->Contour(level, p, p + 2);
+		for (int iteration = 0; iteration < 32; iteration++)
+		{
+			bool improved = false;
+			for (int k = 0; k < 4; k++)
+			{
+				for (int sign = -1; sign <= 1; sign += 2)
+				{
+					double trial[4] = { p[0], p[1], p[2], p[3] };
+					trial[k] = std::min(std::max(p[k] + sign * step[k], lo[k]), hi[k]);
+					if (trial[k] == p[k])
+					{
+						continue;
+					}
+					double value = internals->Contour(level, trial, trial + 2);
+					if (value > best)
+					{
+						best = value;
+						p[k] = trial[k];
+						improved = true;
+					}
+				}
+			}
+			if (!improved)
+			{
+				break;
+			}
+		}
+	}
+
+	center[0] = p[0];
+	center[1] = p[1];
+	radius[0] = p[2];
+	radius[1] = p[3];
+	return true;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseGradientPyramid::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Component: " << this->Component << "\n";
+	os << indent << "Number Of Levels: " << this->NumberOfLevels << "\n";
+	os << indent << "Maximum Number Of Slices: " << this->MaximumNumberOfSlices << "\n";
+	os << indent << "Search Range: " << this->SearchRange << "\n";
+	os << indent << "Cached Slices: " << this->GetNumberOfCachedSlices() << "\n";
+}
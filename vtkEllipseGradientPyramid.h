@@ -0,0 +1,165 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseGradientPyramid.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseGradientPyramid
+* @brief   cached multi-resolution gradient magnitude of image slices
+*
+* vtkEllipseGradientPyramid computes, for a slice of an image, the gradient
+* magnitude of one scalar component at NumberOfLevels resolutions: level 0
+* is the slice itself, and every following level averages 2x2 pixels of the
+* previous one. A slice is only computed the first time it is used, and is
+* then kept until the image is modified or replaced; at most
+* MaximumNumberOfSlices slices are kept, the least recently used being
+* discarded first.
+*
+* RefineEllipse() snaps an axis aligned ellipse to the nearest boundary: the
+* center and semi-axes are moved, coarse to fine through the pyramid, to
+* maximize the mean gradient magnitude sampled along the contour. The search
+* only reads a few hundred samples per step, so it takes a fraction of a
+* millisecond once the pyramid of the slice exists. vtkEllipseWidget uses it
+* to snap the ellipse when a drag ends, see
+* vtkEllipseWidget::SetEdgeSnapping().
+*
+* @sa
+* vtkEllipseWidget vtkEllipseStatistics
+*/
+
+#ifndef vtkEllipseGradientPyramid_h
+#define vtkEllipseGradientPyramid_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkImageData;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseGradientPyramid : public vtkObject
+class vtkEllipseGradientPyramid : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseGradientPyramid *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseGradientPyramid, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the image. Modifying it discards the cached slices.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Specify the slice (the k index, in extent coordinates) the ellipses are
+	* refined on, and the scalar component. Both default to 0. Changing the
+	* component discards the cached slices. A pyramid used by
+	* vtkEllipseWidget::SetGradientPyramid() is not updated by the widget:
+	* the caller must set its Slice to the slice being displayed.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	virtual void SetComponent(int component);
+	vtkGetMacro(Component, int);
+	//@}
+
+	//@{
+	/**
+	* Number of levels of the pyramid, 4 by default. Changing it discards the
+	* cached slices.
+	*/
+	virtual void SetNumberOfLevels(int levels);
+	vtkGetMacro(NumberOfLevels, int);
+	//@}
+
+	//@{
+	/**
+	* Maximum number of slices kept. 8 by default.
+	*/
+	vtkSetClampMacro(MaximumNumberOfSlices, int, 1, VTK_INT_MAX);
+	vtkGetMacro(MaximumNumberOfSlices, int);
+	//@}
+
+	//@{
+	/**
+	* Maximum change of the center and of the semi-axes made by
+	* RefineEllipse(), as a fraction of the semi-axes. 0.25 by default.
+	*/
+	vtkSetClampMacro(SearchRange, double, 0.0, 1.0);
+	vtkGetMacro(SearchRange, double);
+	//@}
+
+	/**
+	* Compute the pyramid of the current slice unless it is cached. Return
+	* false if the input or the slice is invalid. Called by the methods
+	* below; calling it ahead (e.g., when the slice is displayed) hides its
+	* cost from the first refinement.
+	*/
+	bool Prepare();
+
+	/**
+	* Gradient magnitude of level level of the current slice at the world
+	* position (x, y), interpolated bilinearly. 0 outside of the slice.
+	*/
+	double Sample(int level, double x, double y);
+
+	/**
+	* Mean gradient magnitude of level level along the contour of an ellipse
+	* given by its center and semi-axes in world coordinates.
+	*/
+	double EvaluateContour(int level, const double center[2], const double radius[2]);
+
+	/**
+	* Move an ellipse, given by its center and semi-axes in world
+	* coordinates, to the nearby contour of highest mean gradient magnitude
+	* on the current slice. Return false, leaving the ellipse unchanged, if
+	* the pyramid cannot be computed.
+	*/
+	bool RefineEllipse(double center[2], double radius[2]);
+
+	/**
+	* Discard the cached slices.
+	*/
+	void Initialize();
+
+	/**
+	* Number of cached slices.
+	*/
+	int GetNumberOfCachedSlices();
+
+protected:
+	vtkEllipseGradientPyramid();
+	~vtkEllipseGradientPyramid() override;
+
+	vtkImageData *Input;
+	int Slice;
+	int Component;
+	int NumberOfLevels;
+	int MaximumNumberOfSlices;
+	double SearchRange;
+
+	class vtkInternals;
+	vtkInternals *Internals;
+
+private:
+	vtkEllipseGradientPyramid(const vtkEllipseGradientPyramid&) = delete;
+	void operator=(const vtkEllipseGradientPyramid&) = delete;
+};
+
+#endif
@@ -0,0 +1,349 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseLabelMapRasterizer.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseLabelMapRasterizer.h"
+#include "vtkEllipseScanline.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseLabelMapRasterizer);
+
+//-------------------------------------------------------------------------
+// An ellipse in index coordinates, with its rows clipped to the extent
+struct vtkEllipseLabelMapItem
+{
+	vtkEllipseScanline Scanline;
+	int Row0;
+	int Row1;
+	vtkIdType Index;
+	double Label;
+};
+
+//-------------------------------------------------------------------------
+// Write the rows of the label map. The ellipses are sorted by first row;
+// each chunk of rows finds the ellipses active on its first row with a
+// binary search and then maintains the active list (sorted by index, to
+// apply the overlap policy) row by row.
+template <class T>
+class vtkEllipseLabelMapFunctor
+{
+public:
+	T *Base; // first pixel of the output
+	int Extent[4];
+	const std::vector<vtkEllipseLabelMapItem> *Items;
+	int MaximumHeight;
+	T Background;
+	int OverlapPolicy;
+
+	vtkSMPThreadLocal<std::vector<size_t> > Active;
+
+	void Initialize()
+	{
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		const std::vector<vtkEllipseLabelMapItem> &items = *this->Items;
+		std::vector<size_t> &active = this->Active.Local();
+		active.clear();
+
+		// Ellipses starting before this chunk and still active on its first
+		// row start at most MaximumHeight rows before it
+		const vtkIdType firstRow = begin - this->MaximumHeight;
+		size_t next = std::lower_bound(items.begin(), items.end(), firstRow,
+			[](const vtkEllipseLabelMapItem &item, vtkIdType row) { return item.Row0 < row; }) -
+			items.begin();
+
+		const vtkIdType width = this->Extent[1] - this->Extent[0] + 1;
+		for (vtkIdType j = begin; j < end; j++)
+		{
+			// Update the active list
+			active.erase(std::remove_if(active.begin(), active.end(),
+				[&items, j](size_t k) { return items[k].Row1 < j; }), active.end());
+			for (; next < items.size() && items[next].Row0 <= j; next++)
+			{
+				if (items[next].Row1 >= j)
+				{
+					active.insert(std::upper_bound(active.begin(), active.end(), next,
+						[&items](size_t a, size_t b) { return items[a].Index < items[b].Index; }), next);
+				}
+			}
+
+			T *row = this->Base + (j - this->Extent[2]) * width;
+			std::fill(row, row + width, this->Background);
+			if (this->OverlapPolicy == vtkEllipseLabelMapRasterizer::FIRST)
+			{
+				for (auto it = active.rbegin(); it != active.rend(); ++it)
+				{
+					this->FillSpan(row, static_cast<int>(j), items[*it]);
+				}
+			}
+			else
+			{
+				for (auto it = active.begin(); it != active.end(); ++it)
+				{
+					this->FillSpan(row, static_cast<int>(j), items[*it]);
+				}
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+
+	void FillSpan(T *row, int j, const vtkEllipseLabelMapItem &item)
+	{
+		int i0, i1;
+		if (!item.Scanline.GetSpan(j, i0, i1))
+		{
+			return;
+		}
+		i0 = std::max(i0, this->Extent[0]);
+		i1 = std::min(i1, this->Extent[1]);
+		if (i0 > i1)
+		{
+			return;
+		}
+		T label = static_cast<T>(item.Label);
+		T *first = row + (i0 - this->Extent[0]);
+		T *last = row + (i1 - this->Extent[0]) + 1;
+		if (this->OverlapPolicy == vtkEllipseLabelMapRasterizer::MAXIMUM)
+		{
+			for (T *p = first; p != last; ++p)
+			{
+				if (*p == this->Background || *p < label)
+				{
+					*p = label;
+				}
+			}
+		}
+		else
+		{
+			std::fill(first, last, label);
+		}
+	}
+};
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseLabelMapExecute(vtkEllipseLabelMapRasterizer *self, T *base,
+	const int extent[6], const std::vector<vtkEllipseLabelMapItem> &items, int maximumHeight)
+{
+	vtkEllipseLabelMapFunctor<T> functor;
+	functor.Base = base;
+	std::copy(extent, extent + 4, functor.Extent);
+	functor.Items = &items;
+	functor.MaximumHeight = maximumHeight;
+	functor.Background = static_cast<T>(self->GetBackgroundValue());
+	functor.OverlapPolicy = self->GetOverlapPolicy();
+	vtkSMPTools::For(extent[2], extent[3] + 1, functor);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseLabelMapRasterizer::vtkEllipseLabelMapRasterizer()
+{
+	this->Parameters = nullptr;
+	this->Labels = nullptr;
+	this->InformationInput = nullptr;
+	this->OutputOrigin[0] = this->OutputOrigin[1] = this->OutputOrigin[2] = 0.0;
+	this->OutputSpacing[0] = this->OutputSpacing[1] = this->OutputSpacing[2] = 1.0;
+	this->OutputWholeExtent[0] = this->OutputWholeExtent[2] = this->OutputWholeExtent[4] = 0;
+	this->OutputWholeExtent[1] = this->OutputWholeExtent[3] = 255;
+	this->OutputWholeExtent[5] = 0;
+	this->Slice = 0;
+	this->OutputScalarType = VTK_UNSIGNED_SHORT;
+	this->BackgroundValue = 0.0;
+	this->OverlapPolicy = LAST;
+	this->Output = vtkImageData::New();
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseLabelMapRasterizer::~vtkEllipseLabelMapRasterizer()
+{
+	this->SetParameters(nullptr);
+	this->SetLabels(nullptr);
+	this->SetInformationInput(nullptr);
+	this->Output->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::SetParameters(vtkDataArray *parameters)
+{
+	vtkSetObjectBodyMacro(Parameters, vtkDataArray, parameters);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::SetLabels(vtkDataArray *labels)
+{
+	vtkSetObjectBodyMacro(Labels, vtkDataArray, labels);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::SetInformationInput(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(InformationInput, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseLabelMapRasterizer::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Parameters)
+	{
+		mTime = std::max(mTime, this->Parameters->GetMTime());
+	}
+	if (this->Labels)
+	{
+		mTime = std::max(mTime, this->Labels->GetMTime());
+	}
+	if (this->InformationInput)
+	{
+		mTime = std::max(mTime, this->InformationInput->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		this->Compute();
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::Compute()
+{
+	this->Output->Initialize();
+
+	if (this->Parameters && this->Parameters->GetNumberOfComponents() != 4)
+	{
+		vtkErrorMacro(<< "Ellipse parameters with four components are required");
+		return;
+	}
+	vtkIdType n = this->Parameters ? this->Parameters->GetNumberOfTuples() : 0;
+	if (this->Labels && this->Labels->GetNumberOfTuples() < n)
+	{
+		vtkErrorMacro(<< "One label per ellipse is required");
+		return;
+	}
+
+	// Output geometry, a single slice
+	double origin[3], spacing[3];
+	int extent[6];
+	if (this->InformationInput)
+	{
+		this->InformationInput->GetOrigin(origin);
+		this->InformationInput->GetSpacing(spacing);
+		this->InformationInput->GetExtent(extent);
+	}
+	else
+	{
+		std::copy(this->OutputOrigin, this->OutputOrigin + 3, origin);
+		std::copy(this->OutputSpacing, this->OutputSpacing + 3, spacing);
+		std::copy(this->OutputWholeExtent, this->OutputWholeExtent + 6, extent);
+	}
+	extent[4] = extent[5] = this->Slice;
+	if (extent[0] > extent[1] || extent[2] > extent[3])
+	{
+		vtkErrorMacro(<< "The output extent is empty");
+		return;
+	}
+	this->Output->SetOrigin(origin);
+	this->Output->SetSpacing(spacing);
+	this->Output->SetExtent(extent);
+	this->Output->AllocateScalars(this->OutputScalarType, 1);
+	this->Output->GetPointData()->GetScalars()->SetName("Labels");
+
+	// The ellipses in index coordinates, sorted by first row
+	std::vector<vtkEllipseLabelMapItem> items;
+	items.reserve(n);
+	int maximumHeight = 0;
+	for (vtkIdType i = 0; i < n; i++)
+	{
+		double p[4];
+		this->Parameters->GetTuple(i, p);
+		double center[2] = {
+			(p[0] - origin[0]) / spacing[0],
+			(p[1] - origin[1]) / spacing[1] };
+		double radius[2] = {
+			p[2] / fabs(spacing[0]),
+			p[3] / fabs(spacing[1]) };
+		vtkEllipseLabelMapItem item;
+		item.Scanline.SetEllipse(center, radius);
+		if (!item.Scanline.IsValid())
+		{
+			continue;
+		}
+		item.Scanline.GetRowRange(item.Row0, item.Row1);
+		item.Row0 = std::max(item.Row0, extent[2]);
+		item.Row1 = std::min(item.Row1, extent[3]);
+		if (item.Row0 > item.Row1)
+		{
+			continue;
+		}
+		item.Index = i;
+		item.Label = this->Labels ? this->Labels->GetComponent(i, 0) : static_cast<double>(i + 1);
+		maximumHeight = std::max(maximumHeight, item.Row1 - item.Row0);
+		items.push_back(item);
+	}
+	std::sort(items.begin(), items.end(),
+		[](const vtkEllipseLabelMapItem &a, const vtkEllipseLabelMapItem &b)
+	{
+		return a.Row0 < b.Row0 || (a.Row0 == b.Row0 && a.Index < b.Index);
+	});
+
+	void *base = this->Output->GetScalarPointer();
+	switch (this->OutputScalarType)
+	{
+		vtkTemplateMacro(vtkEllipseLabelMapExecute(this, static_cast<VTK_TT*>(base),
+			extent, items, maximumHeight));
+	default:
+		vtkErrorMacro(<< "Unsupported output scalar type");
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseLabelMapRasterizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Parameters: " << this->Parameters << "\n";
+	os << indent << "Labels: " << this->Labels << "\n";
+	os << indent << "Information Input: " << this->InformationInput << "\n";
+	os << indent << "Output Origin: (" << this->OutputOrigin[0] << ", "
+		<< this->OutputOrigin[1] << ", " << this->OutputOrigin[2] << ")\n";
+	os << indent << "Output Spacing: (" << this->OutputSpacing[0] << ", "
+		<< this->OutputSpacing[1] << ", " << this->OutputSpacing[2] << ")\n";
+	os << indent << "Output Whole Extent: (" << this->OutputWholeExtent[0];
+	for (int i = 1; i < 6; i++)
+	{
+		os << ", " << this->OutputWholeExtent[i];
+	}
+	os << ")\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Output Scalar Type: " << this->OutputScalarType << "\n";
+	os << indent << "Background Value: " << this->BackgroundValue << "\n";
+	os << indent << "Overlap Policy: "
+		<< (this->OverlapPolicy == FIRST ? "First\n" :
+			this->OverlapPolicy == MAXIMUM ? "Maximum\n" : "Last\n");
+	os << indent << "Output: " << this->Output << "\n";
+}
@@ -0,0 +1,175 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseLabelMapRasterizer.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseLabelMapRasterizer
+* @brief   rasterize a collection of ellipse ROIs into a label map
+*
+* vtkEllipseLabelMapRasterizer writes a batch of ellipses (center x, center
+* y, semi-axis x, semi-axis y per tuple, in world coordinates) into a single
+* slice label image, e.g., to export annotations as a segmentation. A pixel
+* gets the label of an ellipse when its center is inside it; the labels are
+* given by an optional array, or are the ellipse index plus one.
+*
+* The ellipses are sorted by their first row and the image is written in a
+* single pass: every row is filled with the background value and then with
+* the spans of the ellipses active on that row, found with an active list.
+* Rows are processed in parallel with vtkSMPTools, so the cost is one write
+* of the image plus one write per span pixel, whatever the number of ROIs.
+*
+* Where ellipses overlap, the label written is chosen by the overlap policy:
+* the ellipse that comes LAST (the default) or FIRST in the collection, or
+* the MAXIMUM label.
+*
+* The geometry of the output is copied from an information input image, or
+* given by OutputOrigin, OutputSpacing and OutputWholeExtent. The output is
+* a single slice at z index Slice.
+*
+* @sa
+* vtkEllipseFitter vtkEllipseOverlapAnalysis vtkEllipseScanline
+*/
+
+#ifndef vtkEllipseLabelMapRasterizer_h
+#define vtkEllipseLabelMapRasterizer_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkDataArray;
+class vtkImageData;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseLabelMapRasterizer : public vtkObject
+class vtkEllipseLabelMapRasterizer : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseLabelMapRasterizer *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseLabelMapRasterizer, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipses (four components per tuple: center x, center y,
+	* semi-axis x, semi-axis y) and optionally their labels (one component
+	* per tuple). Without labels, ellipse i gets the label i + 1.
+	*/
+	virtual void SetParameters(vtkDataArray *parameters);
+	vtkGetObjectMacro(Parameters, vtkDataArray);
+	virtual void SetLabels(vtkDataArray *labels);
+	vtkGetObjectMacro(Labels, vtkDataArray);
+	//@}
+
+	//@{
+	/**
+	* Specify an image to copy the origin, spacing and extent of the output
+	* from. It takes precedence over OutputOrigin, OutputSpacing and
+	* OutputWholeExtent.
+	*/
+	virtual void SetInformationInput(vtkImageData *image);
+	vtkGetObjectMacro(InformationInput, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Geometry of the output, when there is no information input. The z range
+	* of the extent is ignored, see Slice.
+	*/
+	vtkSetVector3Macro(OutputOrigin, double);
+	vtkGetVector3Macro(OutputOrigin, double);
+	vtkSetVector3Macro(OutputSpacing, double);
+	vtkGetVector3Macro(OutputSpacing, double);
+	vtkSetVector6Macro(OutputWholeExtent, int);
+	vtkGetVector6Macro(OutputWholeExtent, int);
+	//@}
+
+	//@{
+	/**
+	* The z index of the output slice. 0 by default.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	//@}
+
+	//@{
+	/**
+	* Scalar type of the output, VTK_UNSIGNED_SHORT by default, and the value
+	* of the pixels outside of all the ellipses, 0 by default.
+	*/
+	vtkSetMacro(OutputScalarType, int);
+	vtkGetMacro(OutputScalarType, int);
+	vtkSetMacro(BackgroundValue, double);
+	vtkGetMacro(BackgroundValue, double);
+	//@}
+
+	enum { LAST = 0, FIRST, MAXIMUM };
+
+	//@{
+	/**
+	* Specify the label written where ellipses overlap: the one of the ellipse
+	* that comes LAST (the default) or FIRST in the collection, or the MAXIMUM
+	* label.
+	*/
+	vtkSetClampMacro(OverlapPolicy, int, LAST, MAXIMUM);
+	vtkGetMacro(OverlapPolicy, int);
+	void SetOverlapPolicyToLast() { this->SetOverlapPolicy(LAST); }
+	void SetOverlapPolicyToFirst() { this->SetOverlapPolicy(FIRST); }
+	void SetOverlapPolicyToMaximum() { this->SetOverlapPolicy(MAXIMUM); }
+	//@}
+
+	/**
+	* Rasterize the ellipses if the inputs or the parameters changed since
+	* the last update.
+	*/
+	void Update();
+
+	/**
+	* The label map computed by the last update.
+	*/
+	vtkGetObjectMacro(Output, vtkImageData);
+
+	/**
+	* Return the MTime also considering the inputs.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipseLabelMapRasterizer();
+	~vtkEllipseLabelMapRasterizer() override;
+
+	vtkDataArray *Parameters;
+	vtkDataArray *Labels;
+	vtkImageData *InformationInput;
+	double OutputOrigin[3];
+	double OutputSpacing[3];
+	int OutputWholeExtent[6];
+	int Slice;
+	int OutputScalarType;
+	double BackgroundValue;
+	int OverlapPolicy;
+
+	vtkImageData *Output;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+
+private:
+	vtkEllipseLabelMapRasterizer(const vtkEllipseLabelMapRasterizer&) = delete;
+	void operator=(const vtkEllipseLabelMapRasterizer&) = delete;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseModel.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseModel.h"
+#include "vtkObjectFactory.h"
+
+#include <cmath>
+
+vtkStandardNewMacro(vtkEllipseModel);
+
+//-------------------------------------------------------------------------
+vtkEllipseModel::vtkEllipseModel()
+{
+	this->Point1[0] = this->Point1[1] = this->Point1[2] = 0.0;
+	this->Point2[0] = this->Point2[1] = 1.0;
+	this->Point2[2] = 0.0;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseModel::~vtkEllipseModel() = default;
+
+//-------------------------------------------------------------------------
+void vtkEllipseModel::SetCorners(const double p1[3], const double p2[3])
+{
+	if (this->Point1[0] == p1[0] && this->Point1[1] == p1[1] && this->Point1[2] == p1[2] &&
+		this->Point2[0] == p2[0] && this->Point2[1] == p2[1] && this->Point2[2] == p2[2])
+	{
+		return;
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		this->Point1[i] = p1[i];
+		this->Point2[i] = p2[i];
+	}
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseModel::GetCenter(double center[3])
+{
+	center[0] = 0.5 * (this->Point1[0] + this->Point2[0]);
+	center[1] = 0.5 * (this->Point1[1] + this->Point2[1]);
+	center[2] = this->Point1[2];
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseModel::GetRadius(double radius[2])
+{
+	radius[0] = 0.5 * fabs(this->Point2[0] - this->Point1[0]);
+	radius[1] = 0.5 * fabs(this->Point2[1] - this->Point1[1]);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseModel::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Point1: (" << this->Point1[0] << ", " << this->Point1[1]
+		<< ", " << this->Point1[2] << ")\n";
+	os << indent << "Point2: (" << this->Point2[0] << ", " << this->Point2[1]
+		<< ", " << this->Point2[2] << ")\n";
+}
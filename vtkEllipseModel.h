@@ -0,0 +1,95 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseModel.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseModel
+* @brief   world geometry of an ellipse shared by several representations
+*
+* vtkEllipseModel holds the single source of truth of an ellipse ROI that is
+* displayed in several renderers at once (e.g., linked multi-planar views).
+* The ellipse is defined by two opposite corners of its bounding rectangle in
+* world coordinates, on the plane z = Point1[2].
+*
+* Every vtkEllipseRepresentation attached to the model through SetModel()
+* becomes a lightweight, world anchored view of it: an interaction in any
+* view updates the model once, and each view only re-applies its own cached
+* world-to-display transform when it is rendered. No observers or
+* InteractionEvent cascades are needed to keep the views synchronized.
+*
+* The ellipse is only drawn in views where its plane is not seen edge on:
+* with an axial ROI (constant z), the sagittal and coronal views of a
+* multi-planar layout hide it, and picking there reports Outside.
+*
+* @sa
+* vtkEllipseRepresentation vtkEllipseWidget
+*/
+
+#ifndef vtkEllipseModel_h
+#define vtkEllipseModel_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseModel : public vtkObject
+class vtkEllipseModel : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseModel *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseModel, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify opposite corners of the rectangle bounding the ellipse, in world
+	* coordinates. The ellipse lies on the plane z = Point1[2].
+	*/
+	vtkSetVector3Macro(Point1, double);
+	vtkGetVector3Macro(Point1, double);
+	vtkSetVector3Macro(Point2, double);
+	vtkGetVector3Macro(Point2, double);
+	//@}
+
+	/**
+	* Set both corners at once, modifying the model only once. This is what
+	* the representations use during interaction.
+	*/
+	void SetCorners(const double p1[3], const double p2[3]);
+
+	//@{
+	/**
+	* Convenience methods to get the center and the semi-axis lengths of the
+	* ellipse along x and y.
+	*/
+	void GetCenter(double center[3]);
+	void GetRadius(double radius[2]);
+	//@}
+
+protected:
+	vtkEllipseModel();
+	~vtkEllipseModel() override;
+
+	double Point1[3];
+	double Point2[3];
+
+private:
+	vtkEllipseModel(const vtkEllipseModel&) = delete;
+	void operator=(const vtkEllipseModel&) = delete;
+};
+
+#endif
@@ -0,0 +1,360 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseOverlapAnalysis.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseOverlapAnalysis.h"
+#include "vtkEllipseScanline.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseOverlapAnalysis);
+
+//-------------------------------------------------------------------------
+// Bounding box of an ellipse for the sweep-and-prune broad phase
+struct vtkEllipseOverlapBox
+{
+	double Bounds[4];
+	vtkIdType Id;
+	int Set;
+};
+
+// One entry of the sparse overlap matrix
+struct vtkEllipseOverlapEntry
+{
+	vtkIdType Source;
+	vtkIdType Target;
+	double Intersection;
+	double IoU;
+	double Dice;
+
+	bool operator<(const vtkEllipseOverlapEntry &other) const
+	{
+		return this->Source < other.Source ||
+			(this->Source == other.Source && this->Target < other.Target);
+	}
+};
+
+//-------------------------------------------------------------------------
+// Narrow phase: integrate the intersection of the candidate pairs in parallel
+class vtkEllipseOverlapFunctor
+{
+public:
+	const std::vector<std::pair<vtkIdType, vtkIdType> > *Candidates;
+	const double *Source;
+	const double *Target;
+	double Spacing;
+	vtkSMPThreadLocal<std::vector<vtkEllipseOverlapEntry> > Entries;
+
+	void Initialize()
+	{
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		std::vector<vtkEllipseOverlapEntry> &entries = this->Entries.Local();
+		for (vtkIdType c = begin; c < end; c++)
+		{
+			const std::pair<vtkIdType, vtkIdType> &pair = (*this->Candidates)[c];
+			const double *a = this->Source + 4 * pair.first;
+			const double *b = this->Target + 4 * pair.second;
+			double intersection =
+				vtkEllipseOverlapAnalysis::ComputeIntersection(a, b, this->Spacing);
+			if (intersection <= 0.0)
+			{
+				continue;
+			}
+			double areaA = vtkMath::Pi() * a[2] * a[3];
+			double areaB = vtkMath::Pi() * b[2] * b[3];
+			// the integration error must not push the ratios above one
+			intersection = std::min(intersection, std::min(areaA, areaB));
+
+			vtkEllipseOverlapEntry entry;
+			entry.Source = pair.first;
+			entry.Target = pair.second;
+			entry.Intersection = intersection;
+			entry.IoU = intersection / (areaA + areaB - intersection);
+			entry.Dice = 2.0 * intersection / (areaA + areaB);
+			entries.push_back(entry);
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+//-------------------------------------------------------------------------
+static void vtkEllipseOverlapCopyParameters(vtkDataArray *array, std::vector<double> &flat)
+{
+	vtkIdType n = array->GetNumberOfTuples();
+	flat.resize(4 * n);
+	for (vtkIdType i = 0; i < n; i++)
+	{
+		array->GetTuple(i, &flat[4 * i]);
+		flat[4 * i + 2] = fabs(flat[4 * i + 2]);
+		flat[4 * i + 3] = fabs(flat[4 * i + 3]);
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseOverlapAnalysis::vtkEllipseOverlapAnalysis()
+{
+	this->SourceParameters = nullptr;
+	this->TargetParameters = nullptr;
+	this->SampleSpacing = 0.0;
+	this->NumberOfCandidatePairs = 0;
+
+	this->Pairs = vtkIdTypeArray::New();
+	this->Pairs->SetName("Pairs");
+	this->Pairs->SetNumberOfComponents(2);
+	this->Intersection = vtkDoubleArray::New();
+	this->Intersection->SetName("Intersection");
+	this->IoU = vtkDoubleArray::New();
+	this->IoU->SetName("IoU");
+	this->Dice = vtkDoubleArray::New();
+	this->Dice->SetName("Dice");
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseOverlapAnalysis::~vtkEllipseOverlapAnalysis()
+{
+	this->SetSourceParameters(nullptr);
+	this->SetTargetParameters(nullptr);
+	this->Pairs->Delete();
+	this->Intersection->Delete();
+	this->IoU->Delete();
+	this->Dice->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlapAnalysis::SetSourceParameters(vtkDataArray *parameters)
+{
+	vtkSetObjectBodyMacro(SourceParameters, vtkDataArray, parameters);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlapAnalysis::SetTargetParameters(vtkDataArray *parameters)
+{
+	vtkSetObjectBodyMacro(TargetParameters, vtkDataArray, parameters);
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseOverlapAnalysis::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->SourceParameters)
+	{
+		mTime = std::max(mTime, this->SourceParameters->GetMTime());
+	}
+	if (this->TargetParameters)
+	{
+		mTime = std::max(mTime, this->TargetParameters->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlapAnalysis::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		this->Compute();
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseOverlapAnalysis::ComputeIntersection(const double a[4], const double b[4],
+	double spacing)
+{
+	double y0 = std::max(a[1] - a[3], b[1] - b[3]);
+	double y1 = std::min(a[1] + a[3], b[1] + b[3]);
+	if (y0 >= y1)
+	{
+		return 0.0;
+	}
+
+	// Rows are spread relative to the y extents so that the number of rows
+	// per pair is bounded
+	double h = spacing > 0.0 ? spacing : std::min(a[3], b[3]) / 64.0;
+	if (h <= 0.0)
+	{
+		return 0.0;
+	}
+	int n = std::max(1, static_cast<int>(std::ceil((y1 - y0) / h)));
+	h = (y1 - y0) / n;
+
+	vtkEllipseScanline ea(a, a + 2);
+	vtkEllipseScanline eb(b, b + 2);
+	double length = 0.0;
+	for (int k = 0; k < n; k++)
+	{
+		double y = y0 + (k + 0.5) * h;
+		double a0, a1, b0, b1;
+		if (ea.GetChord(y, a0, a1) && eb.GetChord(y, b0, b1))
+		{
+			double overlap = std::min(a1, b1) - std::max(a0, b0);
+			length += (overlap > 0.0 ? overlap : 0.0);
+		}
+	}
+	return length * h;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlapAnalysis::Compute()
+{
+	this->Pairs->Reset();
+	this->Intersection->Reset();
+	this->IoU->Reset();
+	this->Dice->Reset();
+	this->NumberOfCandidatePairs = 0;
+
+	if (!this->SourceParameters ||
+		this->SourceParameters->GetNumberOfComponents() != 4 ||
+		(this->TargetParameters && this->TargetParameters->GetNumberOfComponents() != 4))
+	{
+		vtkErrorMacro(<< "Ellipse parameters with four components are required");
+		return;
+	}
+
+	int self = (this->TargetParameters == nullptr);
+	std::vector<double> source, target;
+	vtkEllipseOverlapCopyParameters(this->SourceParameters, source);
+	if (!self)
+	{
+		vtkEllipseOverlapCopyParameters(this->TargetParameters, target);
+	}
+
+	// Broad phase: sweep the bounding boxes along x, keeping the boxes whose
+	// x interval is still open in an active list
+	std::vector<vtkEllipseOverlapBox> boxes;
+	for (int set = 0; set < (self ? 1 : 2); set++)
+	{
+		const std::vector<double> &params = (set == 0 ? source : target);
+		vtkIdType n = static_cast<vtkIdType>(params.size() / 4);
+		for (vtkIdType i = 0; i < n; i++)
+		{
+			const double *p = &params[4 * i];
+			vtkEllipseOverlapBox box;
+			box.Bounds[0] = p[0] - p[2];
+			box.Bounds[1] = p[0] + p[2];
+			box.Bounds[2] = p[1] - p[3];
+			box.Bounds[3] = p[1] + p[3];
+			box.Id = i;
+			box.Set = set;
+			boxes.push_back(box);
+		}
+	}
+	std::sort(boxes.begin(), boxes.end(),
+		[](const vtkEllipseOverlapBox &a, const vtkEllipseOverlapBox &b)
+	{
+		return a.Bounds[0] < b.Bounds[0];
+	});
+
+	std::vector<std::pair<vtkIdType, vtkIdType> > candidates;
+	std::vector<const vtkEllipseOverlapBox*> active;
+	for (const vtkEllipseOverlapBox &box : boxes)
+	{
+		size_t kept = 0;
+		for (size_t k = 0; k < active.size(); k++)
+		{
+			const vtkEllipseOverlapBox *other = active[k];
+			if (other->Bounds[1] < box.Bounds[0])
+			{
+				continue; // closed, drop it
+			}
+			active[kept++] = other;
+			if (other->Set == box.Set && !self)
+			{
+				continue;
+			}
+			if (other->Bounds[3] < box.Bounds[2] || other->Bounds[2] > box.Bounds[3])
+			{
+				continue;
+			}
+			if (self)
+			{
+				candidates.push_back(std::make_pair(
+					std::min(box.Id, other->Id), std::max(box.Id, other->Id)));
+			}
+			else if (box.Set == 0)
+			{
+				candidates.push_back(std::make_pair(box.Id, other->Id));
+			}
+			else
+			{
+				candidates.push_back(std::make_pair(other->Id, box.Id));
+			}
+		}
+		active.resize(kept);
+		active.push_back(&box);
+	}
+	this->NumberOfCandidatePairs = static_cast<vtkIdType>(candidates.size());
+	if (candidates.empty())
+	{
+		return;
+	}
+
+	// Narrow phase
+	vtkEllipseOverlapFunctor functor;
+	functor.Candidates = &candidates;
+	functor.Source = source.data();
+	functor.Target = self ? source.data() : target.data();
+	functor.Spacing = this->SampleSpacing;
+	vtkSMPTools::For(0, this->NumberOfCandidatePairs, functor);
+
+	std::vector<vtkEllipseOverlapEntry> entries;
+	for (auto it = functor.Entries.begin(); it != functor.Entries.end(); ++it)
+	{
+		entries.insert(entries.end(), it->begin(), it->end());
+	}
+	std::sort(entries.begin(), entries.end());
+
+	vtkIdType n = static_cast<vtkIdType>(entries.size());
+	this->Pairs->SetNumberOfTuples(n);
+	this->Intersection->SetNumberOfTuples(n);
+	this->IoU->SetNumberOfTuples(n);
+	this->Dice->SetNumberOfTuples(n);
+	for (vtkIdType i = 0; i < n; i++)
+	{
+		const vtkEllipseOverlapEntry &entry = entries[i];
+		this->Pairs->SetTypedComponent(i, 0, entry.Source);
+		this->Pairs->SetTypedComponent(i, 1, entry.Target);
+		this->Intersection->SetValue(i, entry.Intersection);
+		this->IoU->SetValue(i, entry.IoU);
+		this->Dice->SetValue(i, entry.Dice);
+	}
+	this->Pairs->Modified();
+	this->Intersection->Modified();
+	this->IoU->Modified();
+	this->Dice->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlapAnalysis::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Source Parameters: " << this->SourceParameters << "\n";
+	os << indent << "Target Parameters: " << this->TargetParameters << "\n";
+	os << indent << "Sample Spacing: " << this->SampleSpacing << "\n";
+	os << indent << "Number Of Candidate Pairs: " << this->NumberOfCandidatePairs << "\n";
+	os << indent << "Number Of Overlapping Pairs: "
+		<< this->Pairs->GetNumberOfTuples() << "\n";
+}
@@ -0,0 +1,141 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseOverlapAnalysis.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseOverlapAnalysis
+* @brief   pairwise overlap, IoU and Dice of collections of ellipse ROIs
+*
+* vtkEllipseOverlapAnalysis compares collections of axis aligned ellipses,
+* e.g., the ROIs drawn by different annotators. Each collection is a data
+* array with four components per ellipse: center x, center y, semi-axis x
+* and semi-axis y, in world coordinates. When only the source collection is
+* given, every pair of distinct source ellipses is compared; when a target
+* collection is given, every source ellipse is compared with every target
+* ellipse.
+*
+* A sweep-and-prune pass over the ellipse bounding boxes first finds the
+* candidate pairs, so disjoint ellipses cost nothing. The intersection area
+* of each candidate pair is then integrated in parallel by intersecting the
+* scanline chords of both ellipses row by row, with a row spacing of
+* SampleSpacing world units (or 1/64 of the smallest semi-axis of the pair
+* when SampleSpacing is 0). The ellipse areas are exact.
+*
+* The result is a sparse overlap matrix: the pairs with a non-zero overlap,
+* sorted by source then target index, and their intersection area, IoU and
+* Dice coefficient.
+*
+* @sa
+* vtkEllipseScanline vtkEllipseStatistics
+*/
+
+#ifndef vtkEllipseOverlapAnalysis_h
+#define vtkEllipseOverlapAnalysis_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkIdTypeArray;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseOverlapAnalysis : public vtkObject
+class vtkEllipseOverlapAnalysis : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseOverlapAnalysis *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseOverlapAnalysis, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipse collections (four components per tuple: center x,
+	* center y, semi-axis x, semi-axis y). The target collection is optional.
+	*/
+	virtual void SetSourceParameters(vtkDataArray *parameters);
+	vtkGetObjectMacro(SourceParameters, vtkDataArray);
+	virtual void SetTargetParameters(vtkDataArray *parameters);
+	vtkGetObjectMacro(TargetParameters, vtkDataArray);
+	//@}
+
+	//@{
+	/**
+	* Row spacing, in world units, of the scanline integration of the
+	* intersection areas. When 0 (the default), 1/64 of the smallest semi-axis
+	* of each pair is used.
+	*/
+	vtkSetClampMacro(SampleSpacing, double, 0.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(SampleSpacing, double);
+	//@}
+
+	/**
+	* Compare the collections if they changed since the last update.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* The sparse overlap matrix computed by the last update. Pairs holds one
+	* (source index, target index) tuple per overlapping pair; the other
+	* arrays hold one value per pair.
+	*/
+	vtkGetObjectMacro(Pairs, vtkIdTypeArray);
+	vtkGetObjectMacro(Intersection, vtkDoubleArray);
+	vtkGetObjectMacro(IoU, vtkDoubleArray);
+	vtkGetObjectMacro(Dice, vtkDoubleArray);
+	//@}
+
+	/**
+	* Number of candidate pairs found by the broad phase of the last update.
+	*/
+	vtkGetMacro(NumberOfCandidatePairs, vtkIdType);
+
+	/**
+	* Return the MTime also considering the parameter arrays.
+	*/
+	vtkMTimeType GetMTime() override;
+
+	/**
+	* Intersection area of two ellipses (center x, center y, semi-axis x,
+	* semi-axis y) integrated with the given row spacing (0 for automatic).
+	*/
+	static double ComputeIntersection(const double a[4], const double b[4], double spacing);
+
+protected:
+	vtkEllipseOverlapAnalysis();
+	~vtkEllipseOverlapAnalysis() override;
+
+	vtkDataArray *SourceParameters;
+	vtkDataArray *TargetParameters;
+	double SampleSpacing;
+
+	vtkIdTypeArray *Pairs;
+	vtkDoubleArray *Intersection;
+	vtkDoubleArray *IoU;
+	vtkDoubleArray *Dice;
+	vtkIdType NumberOfCandidatePairs;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+
+private:
+	vtkEllipseOverlapAnalysis(const vtkEllipseOverlapAnalysis&) = delete;
+	void operator=(const vtkEllipseOverlapAnalysis&) = delete;
+};
+
+#endif
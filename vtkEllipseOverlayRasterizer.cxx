@@ -0,0 +1,342 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseOverlayRasterizer.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseOverlayRasterizer.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkEllipseScanline.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkProperty2D.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkEllipseOverlayRasterizer);
+
+//-------------------------------------------------------------------------
+// Blend anti-aliased ellipses into a slice of unsigned char pixels. It only
+// holds copies of the settings and of the geometry of the image, so that
+// every call draws with its own painter.
+class vtkEllipseOverlayPainter
+{
+public:
+	unsigned char *Base; // pixel (extent[0], extent[2]) of the slice
+	int Width;
+	int Height;
+	int Components;
+	double Origin[2]; // world position of Base
+	double Spacing[2];
+
+	double LineColor[4]; // one value per component, 0 to 255
+	double LineOpacity;
+	double HalfWidth;
+	double FillColor[4];
+	double FillOpacity; // 0 without fill
+
+	// The color of each component: the luminance for gray images, and an
+	// alpha of 255 so that blending composites the alpha component "over"
+	void SetColor(const double rgb[3], double color[4]) const
+	{
+		if (this->Components < 3)
+		{
+			color[0] = 255.0 * (0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2]);
+			color[1] = 255.0;
+		}
+		else
+		{
+			color[0] = 255.0 * rgb[0];
+			color[1] = 255.0 * rgb[1];
+			color[2] = 255.0 * rgb[2];
+			color[3] = 255.0;
+		}
+		for (int c = 0; c < 4; c++)
+		{
+			color[c] = std::min(std::max(color[c], 0.0), 255.0);
+		}
+	}
+
+	void Blend(unsigned char *pixel, const double color[4], double alpha) const
+	{
+		for (int c = 0; c < this->Components; c++)
+		{
+			double value = pixel[c] + (color[c] - pixel[c]) * alpha;
+			pixel[c] = static_cast<unsigned char>(value + 0.5);
+		}
+	}
+
+	// Blend a pixel from its signed distance to the contour (negative inside),
+	// with the coverage of a one pixel box filter along the normal
+	void BlendEdge(unsigned char *pixel, double distance) const
+	{
+		if (this->FillOpacity > 0.0)
+		{
+			double coverage = std::min(std::max(0.5 - distance, 0.0), 1.0);
+			if (coverage > 0.0)
+			{
+				this->Blend(pixel, this->FillColor, coverage * this->FillOpacity);
+			}
+		}
+		if (this->LineOpacity > 0.0)
+		{
+			double coverage = std::min(distance + 0.5, this->HalfWidth) -
+				std::max(distance - 0.5, -this->HalfWidth);
+			if (coverage > 0.0)
+			{
+				this->Blend(pixel, this->LineColor, coverage * this->LineOpacity);
+			}
+		}
+	}
+
+	void Draw(const double worldCenter[2], const double worldRadius[2]) const
+	{
+		double center[2], radius[2];
+		for (int i = 0; i < 2; i++)
+		{
+			center[i] = (worldCenter[i] - this->Origin[i]) / this->Spacing[i];
+			radius[i] = std::fabs(worldRadius[i] / this->Spacing[i]);
+		}
+		const double minimum = std::min(radius[0], radius[1]);
+		if (!(minimum > 0.0))
+		{
+			return;
+		}
+
+		// Only pixels within margin of the contour are partially covered.
+		// Scaling the ellipse by 1 - margin / minimum keeps it at least margin
+		// inside the contour, and scaling it by 1 + margin / minimum makes it
+		// contain every point within margin outside of the contour.
+		const double margin = this->HalfWidth + 1.0;
+		const double outerScale = 1.0 + margin / minimum;
+		const double innerScale = 1.0 - margin / minimum;
+		double scaled[2] = { radius[0] * outerScale, radius[1] * outerScale };
+		vtkEllipseScanline outer(center, scaled);
+		scaled[0] = radius[0] * innerScale;
+		scaled[1] = radius[1] * innerScale;
+		vtkEllipseScanline inner(center, scaled);
+		const bool hasInterior = innerScale > 0.0;
+
+		int j0, j1;
+		outer.GetRowRange(j0, j1);
+		j0 = std::max(j0, 0);
+		j1 = std::min(j1, this->Height - 1);
+		for (int j = j0; j <= j1; j++)
+		{
+			double x0, x1;
+			if (!outer.GetChord(j, x0, x1))
+			{
+				continue;
+			}
+			const int i0 = std::max(static_cast<int>(std::ceil(x0)), 0);
+			const int i1 = std::min(static_cast<int>(std::floor(x1)), this->Width - 1);
+			if (i0 > i1)
+			{
+				continue;
+			}
+
+			// The span of the interior, entirely inside the contour
+			int k0 = i1 + 1;
+			int k1 = i1;
+			if (hasInterior && inner.GetChord(j, x0, x1))
+			{
+				k0 = std::max(static_cast<int>(std::ceil(x0)), i0);
+				k1 = std::min(static_cast<int>(std::floor(x1)), i1);
+				if (k0 > k1)
+				{
+					k0 = i1 + 1;
+					k1 = i1;
+				}
+			}
+
+			unsigned char *row = this->Base +
+				static_cast<vtkIdType>(j) * this->Width * this->Components;
+			const double v = (j - center[1]) / radius[1];
+			for (int i = i0; i <= i1; i++)
+			{
+				if (i == k0)
+				{
+					for (int k = k0; k <= k1 && this->FillOpacity > 0.0; k++)
+					{
+						this->Blend(row + k * this->Components, this->FillColor, this->FillOpacity);
+					}
+					i = k1;
+					continue;
+				}
+
+				// First order distance to the contour from the level g of the
+				// normalized implicit function, whose gradient norm is
+				// norm / g
+				const double u = (i - center[0]) / radius[0];
+				const double g = std::sqrt(u * u + v * v);
+				const double gx = u / radius[0];
+				const double gy = v / radius[1];
+				const double norm = std::sqrt(gx * gx + gy * gy);
+				const double distance = norm > 0.0 ? g * (g - 1.0) / norm : -minimum;
+				this->BlendEdge(row + i * this->Components, distance);
+			}
+		}
+	}
+};
+
+//-------------------------------------------------------------------------
+// Set up a painter for the pixels of the slice of an image
+static bool vtkEllipseOverlayPrepare(vtkEllipseOverlayRasterizer *self,
+	vtkImageData *image, vtkEllipseOverlayPainter &painter)
+{
+	vtkDataArray *scalars = image ? image->GetPointData()->GetScalars() : nullptr;
+	if (!scalars || scalars->GetDataType() != VTK_UNSIGNED_CHAR ||
+		scalars->GetNumberOfComponents() < 1 || scalars->GetNumberOfComponents() > 4)
+	{
+		vtkErrorWithObjectMacro(self, << "An image with 1 to 4 unsigned char components is required");
+		return false;
+	}
+	int extent[6];
+	image->GetExtent(extent);
+	const int slice = self->GetSlice();
+	if (extent[0] > extent[1] || extent[2] > extent[3] ||
+		slice < extent[4] || slice > extent[5])
+	{
+		vtkErrorWithObjectMacro(self, << "Slice " << slice << " is outside of the image");
+		return false;
+	}
+
+	double origin[3], spacing[3];
+	image->GetOrigin(origin);
+	image->GetSpacing(spacing);
+	if (spacing[0] == 0.0 || spacing[1] == 0.0)
+	{
+		vtkErrorWithObjectMacro(self, << "The spacing of the image is zero");
+		return false;
+	}
+	painter.Width = extent[1] - extent[0] + 1;
+	painter.Height = extent[3] - extent[2] + 1;
+	painter.Components = scalars->GetNumberOfComponents();
+	painter.Base = static_cast<unsigned char*>(scalars->GetVoidPointer(0)) +
+		static_cast<vtkIdType>(slice - extent[4]) * painter.Width * painter.Height *
+		painter.Components;
+	for (int i = 0; i < 2; i++)
+	{
+		painter.Origin[i] = origin[i] + extent[2 * i] * spacing[i];
+		painter.Spacing[i] = spacing[i];
+	}
+	painter.SetColor(self->GetColor(), painter.LineColor);
+	painter.HalfWidth = 0.5 * self->GetLineWidth();
+	painter.LineOpacity = painter.HalfWidth > 0.0 ? self->GetOpacity() : 0.0;
+	painter.SetColor(self->GetFillColor(), painter.FillColor);
+	painter.FillOpacity = self->GetFill() ? self->GetFillOpacity() : 0.0;
+	return true;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseOverlayRasterizer::vtkEllipseOverlayRasterizer()
+{
+	this->Color[0] = this->Color[1] = this->Color[2] = 1.0;
+	this->Opacity = 1.0;
+	this->LineWidth = 1.0;
+	this->Fill = 0;
+	this->FillColor[0] = this->FillColor[1] = this->FillColor[2] = 1.0;
+	this->FillOpacity = 0.3;
+	this->Slice = 0;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseOverlayRasterizer::~vtkEllipseOverlayRasterizer()
+{
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlayRasterizer::SetStyleFromRepresentation(vtkEllipseRepresentation *rep)
+{
+	if (!rep)
+	{
+		return;
+	}
+	vtkProperty2D *property = rep->GetEllipseProperty();
+	this->SetColor(property->GetColor());
+	this->SetOpacity(property->GetOpacity());
+	this->SetLineWidth(property->GetLineWidth());
+	this->SetFill(rep->GetFill());
+	this->SetFillColor(rep->GetFillProperty()->GetColor());
+	this->SetFillOpacity(rep->GetFillProperty()->GetOpacity());
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseOverlayRasterizer::DrawEllipse(vtkImageData *image,
+	const double center[2], const double radius[2])
+{
+	vtkEllipseOverlayPainter painter;
+	if (!vtkEllipseOverlayPrepare(this, image, painter))
+	{
+		return 0;
+	}
+	painter.Draw(center, radius);
+	image->GetPointData()->GetScalars()->Modified();
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseOverlayRasterizer::DrawEllipses(vtkImageData *image, vtkDataArray *parameters)
+{
+	if (!parameters || parameters->GetNumberOfComponents() != 4)
+	{
+		vtkErrorMacro(<< "Ellipse parameters with four components are required");
+		return 0;
+	}
+	vtkEllipseOverlayPainter painter;
+	if (!vtkEllipseOverlayPrepare(this, image, painter))
+	{
+		return 0;
+	}
+	for (vtkIdType i = 0; i < parameters->GetNumberOfTuples(); i++)
+	{
+		double p[4];
+		parameters->GetTuple(i, p);
+		painter.Draw(p, p + 2);
+	}
+	image->GetPointData()->GetScalars()->Modified();
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseOverlayRasterizer::DrawRepresentation(vtkImageData *image,
+	vtkEllipseRepresentation *rep)
+{
+	if (!rep || rep->GetAnchorMode() != vtkEllipseRepresentation::ANCHOR_WORLD)
+	{
+		vtkErrorMacro(<< "A world anchored representation is required");
+		return 0;
+	}
+	double w1[3], w2[3];
+	rep->GetWorldCorners(w1, w2);
+	double center[2], radius[2];
+	for (int i = 0; i < 2; i++)
+	{
+		center[i] = 0.5 * (w1[i] + w2[i]);
+		radius[i] = 0.5 * fabs(w2[i] - w1[i]);
+	}
+	return this->DrawEllipse(image, center, radius);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseOverlayRasterizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Color: (" << this->Color[0] << ", "
+		<< this->Color[1] << ", " << this->Color[2] << ")\n";
+	os << indent << "Opacity: " << this->Opacity << "\n";
+	os << indent << "Line Width: " << this->LineWidth << "\n";
+	os << indent << "Fill: " << (this->Fill ? "On\n" : "Off\n");
+	os << indent << "Fill Color: (" << this->FillColor[0] << ", "
+		<< this->FillColor[1] << ", " << this->FillColor[2] << ")\n";
+	os << indent << "Fill Opacity: " << this->FillOpacity << "\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+}
@@ -0,0 +1,154 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseOverlayRasterizer.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseOverlayRasterizer
+* @brief   draw anti-aliased ellipses into images without a render window
+*
+* vtkEllipseOverlayRasterizer burns ellipse outlines, and optionally their
+* fill, into the pixels of an unsigned char image with one (gray), two (gray
+* and alpha), three (RGB) or four (RGBA) components, e.g. to produce key
+* images and thumbnails with their ROIs. Ellipses are given in the world
+* coordinates of the image, as center and semi-axes, as a parameters array
+* or by a world anchored vtkEllipseRepresentation, whose style can be copied
+* with SetStyleFromRepresentation().
+*
+* Drawing is done on the CPU, without any render window or OpenGL context.
+* The coverage of a pixel by the outline and by the fill is computed from a
+* first order estimate of its distance to the contour, which is exact for a
+* box filter along the normal of the contour, and the colors are blended
+* with that coverage times the opacity. Only the pixels within one pixel of
+* the outline are evaluated one by one; the rows of the interior are found
+* with vtkEllipseScanline and filled as spans.
+*
+* The Draw methods only read the settings of the rasterizer and write the
+* pixels of the image they are given: a single rasterizer can draw into
+* different images from any number of threads at the same time, as long as
+* its settings are not modified meanwhile. Each image is drawn serially, the
+* parallelism being across images.
+*
+* @sa
+* vtkEllipseLabelMapRasterizer vtkEllipseScanline vtkEllipseRepresentation
+*/
+
+#ifndef vtkEllipseOverlayRasterizer_h
+#define vtkEllipseOverlayRasterizer_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkDataArray;
+class vtkImageData;
+class vtkEllipseRepresentation;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseOverlayRasterizer : public vtkObject
+class vtkEllipseOverlayRasterizer : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseOverlayRasterizer *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseOverlayRasterizer, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Color (RGB, 0 to 1) and opacity of the outline. White and opaque by
+	* default. Gray images get the luminance of the color.
+	*/
+	vtkSetVector3Macro(Color, double);
+	vtkGetVector3Macro(Color, double);
+	vtkSetClampMacro(Opacity, double, 0.0, 1.0);
+	vtkGetMacro(Opacity, double);
+	//@}
+
+	//@{
+	/**
+	* Width of the outline in pixels, centered on the contour. 1 by default;
+	* 0 draws no outline.
+	*/
+	vtkSetClampMacro(LineWidth, double, 0.0, 1000.0);
+	vtkGetMacro(LineWidth, double);
+	//@}
+
+	//@{
+	/**
+	* Fill the interior of the ellipses with FillColor and FillOpacity (white,
+	* with an opacity of 0.3, by default). Off by default.
+	*/
+	vtkSetMacro(Fill, vtkTypeBool);
+	vtkGetMacro(Fill, vtkTypeBool);
+	vtkBooleanMacro(Fill, vtkTypeBool);
+	vtkSetVector3Macro(FillColor, double);
+	vtkGetVector3Macro(FillColor, double);
+	vtkSetClampMacro(FillOpacity, double, 0.0, 1.0);
+	vtkGetMacro(FillOpacity, double);
+	//@}
+
+	//@{
+	/**
+	* Specify the slice (the k index, in extent coordinates) drawn into. 0 by
+	* default.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	//@}
+
+	/**
+	* Copy the color, opacity and line width of the EllipseProperty, and the
+	* Fill flag and FillProperty of a representation.
+	*/
+	void SetStyleFromRepresentation(vtkEllipseRepresentation *rep);
+
+	/**
+	* Draw an ellipse, given by its center and semi-axes in the world
+	* coordinates of the image, into Slice of the image. Return 0 if the
+	* image is not supported.
+	*/
+	int DrawEllipse(vtkImageData *image, const double center[2], const double radius[2]);
+
+	/**
+	* Draw ellipses given by a parameters array (four components per tuple:
+	* center x, center y, semi-axis x, semi-axis y, in world coordinates) in
+	* the order of the array.
+	*/
+	int DrawEllipses(vtkImageData *image, vtkDataArray *parameters);
+
+	/**
+	* Draw the ellipse of a world anchored representation. The
+	* representation must not be modified while it is drawn.
+	*/
+	int DrawRepresentation(vtkImageData *image, vtkEllipseRepresentation *rep);
+
+protected:
+	vtkEllipseOverlayRasterizer();
+	~vtkEllipseOverlayRasterizer() override;
+
+	double Color[3];
+	double Opacity;
+	double LineWidth;
+	vtkTypeBool Fill;
+	double FillColor[3];
+	double FillOpacity;
+	int Slice;
+
+private:
+	vtkEllipseOverlayRasterizer(const vtkEllipseOverlayRasterizer&) = delete;
+	void operator=(const vtkEllipseOverlayRasterizer&) = delete;
+};
+
+#endif
@@ -0,0 +1,436 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseProfile.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseProfile.h"
+#include "vtkEllipseStatistics.h"
+#include "vtkEllipseScanline.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkTable.h"
+#include "vtkMath.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSmartPointer.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseProfile);
+
+//-------------------------------------------------------------------------
+// Accumulate the pixels of the ellipse into shell x sector bins. On each
+// row, the shell boundaries (where the normalized radius is k / shells),
+// the sector boundaries (where the row crosses a sector ray) and the center
+// split the span into segments of pixels that all fall into the same bin;
+// the bin is found once per segment, at its middle.
+template <class T>
+class vtkEllipseProfileFunctor
+{
+public:
+	const T *Base; // pixel (Extent[0], Extent[2]) of the slice
+	vtkIdType Increments[2];
+	int Extent[4];
+	vtkEllipseScanline Scanline;
+	double Center[2]; // in index coordinates
+	double Radius[2];
+	double Sign[2]; // orientation of the index axes in world space
+	int NumberOfShells;
+	int NumberOfSectors;
+	std::vector<double> RayX; // direction of the sector rays, normalized
+	std::vector<double> RayY; // index coordinates
+
+	vtkSMPThreadLocal<std::vector<vtkEllipseStatisticsAccumulator> > Bins;
+	vtkSMPThreadLocal<std::vector<double> > Breaks;
+	std::vector<vtkEllipseStatisticsAccumulator> Result;
+
+	void Initialize()
+	{
+		this->Bins.Local().assign(this->NumberOfShells * this->NumberOfSectors,
+			vtkEllipseStatisticsAccumulator());
+	}
+
+	int GetBin(double u, double v) const
+	{
+		int shell = static_cast<int>(std::sqrt(u * u + v * v) * this->NumberOfShells);
+		shell = std::min(shell, this->NumberOfShells - 1);
+		if (this->NumberOfSectors == 1)
+		{
+			return shell;
+		}
+		double angle = std::atan2(this->Sign[1] * v, this->Sign[0] * u);
+		if (angle < 0.0)
+		{
+			angle += 2.0 * vtkMath::Pi();
+		}
+		int sector = static_cast<int>(angle * this->NumberOfSectors / (2.0 * vtkMath::Pi()));
+		sector = std::min(sector, this->NumberOfSectors - 1);
+		return shell * this->NumberOfSectors + sector;
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		this->AddRows(begin, end, this->Bins.Local(), this->Breaks.Local());
+	}
+
+	void AddRows(vtkIdType begin, vtkIdType end,
+		std::vector<vtkEllipseStatisticsAccumulator> &bins, std::vector<double> &breaks) const
+	{
+		for (vtkIdType j = begin; j < end; j++)
+		{
+			int i0, i1;
+			if (!this->Scanline.GetSpan(static_cast<int>(j), i0, i1))
+			{
+				continue;
+			}
+			i0 = std::max(i0, this->Extent[0]);
+			i1 = std::min(i1, this->Extent[1]);
+			if (i0 > i1)
+			{
+				continue;
+			}
+
+			// Boundaries crossing this row, in index coordinates
+			double v = (j - this->Center[1]) / this->Radius[1];
+			breaks.clear();
+			breaks.push_back(this->Center[0]);
+			for (int k = 1; k < this->NumberOfShells; k++)
+			{
+				double t = static_cast<double>(k) / this->NumberOfShells;
+				double h = t * t - v * v;
+				if (h > 0.0)
+				{
+					double w = std::sqrt(h) * this->Radius[0];
+					breaks.push_back(this->Center[0] - w);
+					breaks.push_back(this->Center[0] + w);
+				}
+			}
+			if (this->NumberOfSectors > 1)
+			{
+				for (size_t m = 0; m < this->RayX.size(); m++)
+				{
+					if (this->RayY[m] != 0.0 && v * this->RayY[m] > 0.0)
+					{
+						breaks.push_back(this->Center[0] +
+							v * this->RayX[m] / this->RayY[m] * this->Radius[0]);
+					}
+				}
+			}
+			std::sort(breaks.begin(), breaks.end());
+
+			// Walk the segments of the span
+			const T *row = this->Base + (j - this->Extent[2]) * this->Increments[1];
+			size_t b = 0;
+			for (int i = i0; i <= i1;)
+			{
+				while (b < breaks.size() && breaks[b] <= i)
+				{
+					b++;
+				}
+				int last = i1;
+				if (b < breaks.size())
+				{
+					last = std::min(i1, static_cast<int>(std::ceil(breaks[b])) - 1);
+				}
+
+				double u = (0.5 * (i + last) - this->Center[0]) / this->Radius[0];
+				vtkEllipseStatisticsAccumulator &bin = bins[this->GetBin(u, v)];
+				const T *p = row + (i - this->Extent[0]) * this->Increments[0];
+				for (; i <= last; i++, p += this->Increments[0])
+				{
+					bin.Add(static_cast<double>(*p));
+				}
+			}
+		}
+	}
+
+	void Reduce()
+	{
+		this->Result.assign(this->NumberOfShells * this->NumberOfSectors,
+			vtkEllipseStatisticsAccumulator());
+		for (auto it = this->Bins.begin(); it != this->Bins.end(); ++it)
+		{
+			for (size_t k = 0; k < this->Result.size(); k++)
+			{
+				this->Result[k].Merge((*it)[k]);
+			}
+		}
+	}
+};
+
+//-------------------------------------------------------------------------
+// Reproducible mode: the rows are split into a number of blocks that only
+// depends on the number of rows, each block is accumulated sequentially
+// into its own bins, and the blocks are merged in index order
+template <class T>
+class vtkEllipseProfileBlockFunctor
+{
+public:
+	const vtkEllipseProfileFunctor<T> *Rows;
+	vtkIdType FirstRow;
+	vtkIdType NumberOfRows;
+	vtkIdType NumberOfBlocks;
+	std::vector<std::vector<vtkEllipseStatisticsAccumulator> > Blocks;
+	vtkSMPThreadLocal<std::vector<double> > Breaks;
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		for (vtkIdType b = begin; b < end; b++)
+		{
+			this->Rows->AddRows(
+				this->FirstRow + this->NumberOfRows * b / this->NumberOfBlocks,
+				this->FirstRow + this->NumberOfRows * (b + 1) / this->NumberOfBlocks,
+				this->Blocks[b], this->Breaks.Local());
+		}
+	}
+};
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseProfileExecute(vtkEllipseProfile *self, const T *base,
+	const vtkIdType increments[3], const int extent[6], const vtkEllipseScanline &scanline,
+	const double sign[2], std::vector<vtkEllipseStatisticsAccumulator> &result)
+{
+	vtkEllipseProfileFunctor<T> functor;
+	functor.Base = base;
+	functor.Increments[0] = increments[0];
+	functor.Increments[1] = increments[1];
+	std::copy(extent, extent + 4, functor.Extent);
+	functor.Scanline = scanline;
+	std::copy(scanline.GetCenter(), scanline.GetCenter() + 2, functor.Center);
+	std::copy(scanline.GetRadius(), scanline.GetRadius() + 2, functor.Radius);
+	functor.Sign[0] = sign[0];
+	functor.Sign[1] = sign[1];
+	functor.NumberOfShells = self->GetNumberOfShells();
+	functor.NumberOfSectors = self->GetNumberOfSectors();
+	for (int m = 0; m < functor.NumberOfSectors; m++)
+	{
+		double angle = 2.0 * vtkMath::Pi() * m / functor.NumberOfSectors;
+		functor.RayX.push_back(sign[0] * cos(angle));
+		functor.RayY.push_back(sign[1] * sin(angle));
+	}
+
+	int j0, j1;
+	scanline.GetRowRange(j0, j1);
+	j0 = std::max(j0, extent[2]);
+	j1 = std::min(j1, extent[3]);
+	const int numberOfBins = functor.NumberOfShells * functor.NumberOfSectors;
+	if (j0 > j1)
+	{
+		result.assign(numberOfBins, vtkEllipseStatisticsAccumulator());
+	}
+	else if (self->GetReproducible())
+	{
+		// At most 64 blocks, to bound the memory of the bins
+		vtkEllipseProfileBlockFunctor<T> blocks;
+		blocks.Rows = &functor;
+		blocks.FirstRow = j0;
+		blocks.NumberOfRows = j1 - j0 + 1;
+		blocks.NumberOfBlocks = std::min<vtkIdType>(64, std::max<vtkIdType>(1,
+			blocks.NumberOfRows / vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE));
+		blocks.Blocks.assign(blocks.NumberOfBlocks,
+			std::vector<vtkEllipseStatisticsAccumulator>(numberOfBins));
+		vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, blocks);
+
+		result.assign(numberOfBins, vtkEllipseStatisticsAccumulator());
+		for (const auto &block : blocks.Blocks)
+		{
+			for (int k = 0; k < numberOfBins; k++)
+			{
+				result[k].Merge(block[k]);
+			}
+		}
+	}
+	else
+	{
+		vtkSMPTools::For(j0, j1 + 1, functor);
+		result = functor.Result;
+		result.resize(numberOfBins);
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseProfile::vtkEllipseProfile()
+{
+	this->Input = nullptr;
+	this->Center[0] = this->Center[1] = 0.0;
+	this->Radius[0] = this->Radius[1] = 1.0;
+	this->Slice = 0;
+	this->Component = 0;
+	this->NumberOfShells = 4;
+	this->NumberOfSectors = 1;
+	this->Reproducible = 0;
+	this->Output = vtkTable::New();
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseProfile::~vtkEllipseProfile()
+{
+	this->SetInputData(nullptr);
+	this->Output->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProfile::SetInputData(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProfile::SetCorners(const double p1[2], const double p2[2])
+{
+	this->SetCenter(0.5 * (p1[0] + p2[0]), 0.5 * (p1[1] + p2[1]));
+	this->SetRadius(0.5 * fabs(p2[0] - p1[0]), 0.5 * fabs(p2[1] - p1[1]));
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseProfile::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Input)
+	{
+		mTime = std::max(mTime, this->Input->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProfile::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		this->Compute();
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProfile::Compute()
+{
+	this->Output->Initialize();
+
+	vtkDataArray *scalars = this->Input ? this->Input->GetPointData()->GetScalars() : nullptr;
+	if (!scalars)
+	{
+		vtkErrorMacro(<< "No input scalars to compute a profile on");
+		return;
+	}
+	if (this->Component >= scalars->GetNumberOfComponents())
+	{
+		vtkErrorMacro(<< "Component " << this->Component << " is out of range");
+		return;
+	}
+
+	int extent[6];
+	double origin[3], spacing[3];
+	vtkIdType increments[3];
+	this->Input->GetExtent(extent);
+	this->Input->GetOrigin(origin);
+	this->Input->GetSpacing(spacing);
+	this->Input->GetIncrements(increments);
+	if (this->Slice < extent[4] || this->Slice > extent[5])
+	{
+		vtkErrorMacro(<< "Slice " << this->Slice << " is outside of the input extent");
+		return;
+	}
+
+	// The ellipse in continuous index coordinates
+	double pixelArea = fabs(spacing[0] * spacing[1]);
+	double sign[2] = { spacing[0] < 0.0 ? -1.0 : 1.0, spacing[1] < 0.0 ? -1.0 : 1.0 };
+	double center[2] = {
+		(this->Center[0] - origin[0]) / spacing[0],
+		(this->Center[1] - origin[1]) / spacing[1] };
+	double radius[2] = {
+		this->Radius[0] / fabs(spacing[0]),
+		this->Radius[1] / fabs(spacing[1]) };
+	vtkEllipseScanline scanline(center, radius);
+
+	const int shells = this->NumberOfShells;
+	const int sectors = this->NumberOfSectors;
+	std::vector<vtkEllipseStatisticsAccumulator> bins(shells * sectors);
+	if (scanline.IsValid())
+	{
+		void *base = this->Input->GetScalarPointer(extent[0], extent[2], this->Slice);
+		switch (scalars->GetDataType())
+		{
+			vtkTemplateMacro(vtkEllipseProfileExecute(this,
+				static_cast<const VTK_TT*>(base) + this->Component, increments, extent,
+				scanline, sign, bins));
+		default:
+			vtkErrorMacro(<< "Unsupported scalar type");
+			return;
+		}
+	}
+
+	// One row per shell and sector
+	const char *intNames[] = { "Shell", "Sector" };
+	const char *doubleNames[] = { "InnerRadius", "OuterRadius", "StartAngle", "EndAngle",
+		"Count", "Area", "Mean", "StandardDeviation", "Minimum", "Maximum" };
+	vtkIntArray *intColumns[2];
+	vtkDoubleArray *doubleColumns[10];
+	for (int c = 0; c < 2; c++)
+	{
+		vtkSmartPointer<vtkIntArray> column = vtkSmartPointer<vtkIntArray>::New();
+		column->SetName(intNames[c]);
+		column->SetNumberOfTuples(shells * sectors);
+		this->Output->AddColumn(column);
+		intColumns[c] = column;
+	}
+	for (int c = 0; c < 10; c++)
+	{
+		vtkSmartPointer<vtkDoubleArray> column = vtkSmartPointer<vtkDoubleArray>::New();
+		column->SetName(doubleNames[c]);
+		column->SetNumberOfTuples(shells * sectors);
+		this->Output->AddColumn(column);
+		doubleColumns[c] = column;
+	}
+
+	for (int s = 0; s < shells; s++)
+	{
+		for (int m = 0; m < sectors; m++)
+		{
+			vtkIdType row = s * sectors + m;
+			const vtkEllipseStatisticsAccumulator &bin = bins[row];
+			bool empty = bin.Weight <= 0.0;
+			intColumns[0]->SetValue(row, s);
+			intColumns[1]->SetValue(row, m);
+			doubleColumns[0]->SetValue(row, static_cast<double>(s) / shells);
+			doubleColumns[1]->SetValue(row, static_cast<double>(s + 1) / shells);
+			doubleColumns[2]->SetValue(row, 360.0 * m / sectors);
+			doubleColumns[3]->SetValue(row, 360.0 * (m + 1) / sectors);
+			doubleColumns[4]->SetValue(row, bin.Weight);
+			doubleColumns[5]->SetValue(row, bin.Weight * pixelArea);
+			doubleColumns[6]->SetValue(row, bin.GetMean());
+			doubleColumns[7]->SetValue(row, std::sqrt(bin.GetVariance()));
+			doubleColumns[8]->SetValue(row, empty ? 0.0 : bin.Minimum);
+			doubleColumns[9]->SetValue(row, empty ? 0.0 : bin.Maximum);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProfile::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Center: (" << this->Center[0] << ", " << this->Center[1] << ")\n";
+	os << indent << "Radius: (" << this->Radius[0] << ", " << this->Radius[1] << ")\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Component: " << this->Component << "\n";
+	os << indent << "Number Of Shells: " << this->NumberOfShells << "\n";
+	os << indent << "Number Of Sectors: " << this->NumberOfSectors << "\n";
+	os << indent << "Reproducible: " << (this->Reproducible ? "On\n" : "Off\n");
+	os << indent << "Output: " << this->Output << "\n";
+}
@@ -0,0 +1,167 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseProfile.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseProfile
+* @brief   radial and angular intensity profile inside an ellipse ROI
+*
+* vtkEllipseProfile splits an axis aligned ellipse ROI of a vtkImageData
+* slice into NumberOfShells concentric elliptical shells of equal normalized
+* radius width and NumberOfSectors angular sectors, and computes the
+* intensity statistics of every shell and sector, e.g., for heterogeneity
+* analysis. The normalized radius of a pixel is its elliptical radius (1 on
+* the ellipse) and its angle is the elliptic angle, counterclockwise from the
+* world x axis, so the sectors are equal in normalized coordinates.
+*
+* A pixel belongs to the ROI when its center is inside the ellipse, as in the
+* BINARY mode of vtkEllipseStatistics. The shell and sector boundaries
+* crossing each row span are found analytically, and the pixels between two
+* boundaries are accumulated into one bin without computing their radius or
+* angle. The rows are processed in parallel with vtkSMPTools and per-thread
+* bins, or, with Reproducible on, in a fixed number of row blocks with their
+* own bins that are merged in order, for results independent of the number
+* of threads.
+*
+* The output is a vtkTable with one row per shell and sector (sector index
+* varying fastest) and the columns Shell, Sector, InnerRadius, OuterRadius,
+* StartAngle, EndAngle (in degrees), Count, Area, Mean, StandardDeviation,
+* Minimum and Maximum.
+*
+* @sa
+* vtkEllipseStatistics vtkEllipseScanline
+*/
+
+#ifndef vtkEllipseProfile_h
+#define vtkEllipseProfile_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkImageData;
+class vtkTable;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseProfile : public vtkObject
+class vtkEllipseProfile : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseProfile *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseProfile, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the image to measure.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipse by its center and semi-axis lengths along x and y,
+	* in world coordinates.
+	*/
+	vtkSetVector2Macro(Center, double);
+	vtkGetVector2Macro(Center, double);
+	vtkSetVector2Macro(Radius, double);
+	vtkGetVector2Macro(Radius, double);
+	//@}
+
+	/**
+	* Convenience method to specify the ellipse by two opposite corners of its
+	* bounding rectangle in world coordinates.
+	*/
+	void SetCorners(const double p1[2], const double p2[2]);
+
+	//@{
+	/**
+	* Specify the slice (the k index, in extent coordinates) and the scalar
+	* component to measure. Both default to 0.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+	vtkGetMacro(Component, int);
+	//@}
+
+	//@{
+	/**
+	* Number of concentric shells, 4 by default, and of angular sectors, 1 by
+	* default (a purely radial profile).
+	*/
+	vtkSetClampMacro(NumberOfShells, int, 1, 1024);
+	vtkGetMacro(NumberOfShells, int);
+	vtkSetClampMacro(NumberOfSectors, int, 1, 3600);
+	vtkGetMacro(NumberOfSectors, int);
+	//@}
+
+	//@{
+	/**
+	* Make the results bit for bit reproducible whatever the number of
+	* threads. The rows of the ROI are split into a number of blocks that
+	* only depends on the number of rows (one per
+	* vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE rows, at most 64), each
+	* block is summed sequentially into its own bins, and the blocks are
+	* merged in index order. Off by default.
+	*/
+	vtkSetMacro(Reproducible, vtkTypeBool);
+	vtkGetMacro(Reproducible, vtkTypeBool);
+	vtkBooleanMacro(Reproducible, vtkTypeBool);
+	//@}
+
+	/**
+	* Compute the profile if the input or the parameters changed since the
+	* last update.
+	*/
+	void Update();
+
+	/**
+	* The profile computed by the last update.
+	*/
+	vtkGetObjectMacro(Output, vtkTable);
+
+	/**
+	* Return the MTime also considering the input image.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipseProfile();
+	~vtkEllipseProfile() override;
+
+	vtkImageData *Input;
+	double Center[2];
+	double Radius[2];
+	int Slice;
+	int Component;
+	int NumberOfShells;
+	int NumberOfSectors;
+	vtkTypeBool Reproducible;
+
+	vtkTable *Output;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+
+private:
+	vtkEllipseProfile(const vtkEllipseProfile&) = delete;
+	void operator=(const vtkEllipseProfile&) = delete;
+};
+
+#endif
@@ -0,0 +1,876 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseProgressiveStatistics.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseProgressiveStatistics.h"
+#include "vtkEllipseScanline.h"
+#include "vtkEllipseWidget.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkEllipseTrace.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkCallbackCommand.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkMath.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseProgressiveStatistics);
+
+namespace
+{
+// Level l of the pyramid. Pixel (i, j) covers the image pixels
+// [i * Scale, (i + 1) * Scale) x [j * Scale, (j + 1) * Scale), clipped to
+// the slice, and holds their mean and the mean of their squares.
+struct vtkEllipseProgressiveLevel
+{
+	int Size[2];
+	int Scale;
+	std::vector<float> Mean;
+	std::vector<float> MeanOfSquares;
+};
+
+// Sources give the functors the blocks of a level: Get() returns the
+// number of image pixels of block (i, j), their mean and the mean of their
+// squares. Indices start at the first pixel of the slice.
+template <class T>
+struct vtkEllipseProgressiveImageSource
+{
+	const T *Base;
+	vtkIdType Increments[2];
+	int Size[2];
+
+	void Get(int i, int j, double &w, double &m, double &m2) const
+	{
+		double v = static_cast<double>(this->Base[j * this->Increments[1] + i * this->Increments[0]]);
+		w = 1.0;
+		m = v;
+		m2 = v * v;
+	}
+};
+
+struct vtkEllipseProgressiveLevelSource
+{
+	const vtkEllipseProgressiveLevel *Level;
+	int BaseSize[2];
+	int Size[2];
+
+	void Get(int i, int j, double &w, double &m, double &m2) const
+	{
+		const int s = this->Level->Scale;
+		w = static_cast<double>(std::min(s, this->BaseSize[0] - i * s)) *
+			std::min(s, this->BaseSize[1] - j * s);
+		vtkIdType k = static_cast<vtkIdType>(j) * this->Size[0] + i;
+		m = this->Level->Mean[k];
+		m2 = this->Level->MeanOfSquares[k];
+	}
+};
+
+//-------------------------------------------------------------------------
+// Combine the 2 x 2 blocks of a source into the rows of the next level
+template <class TSource>
+class vtkEllipseProgressiveReduceFunctor
+{
+public:
+	const TSource *Source;
+	vtkEllipseProgressiveLevel *Level;
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		const int nx = this->Level->Size[0];
+		for (vtkIdType jj = begin; jj < end; jj++)
+		{
+			int j = static_cast<int>(jj);
+			for (int i = 0; i < nx; i++)
+			{
+				double weight = 0.0, sum = 0.0, sumOfSquares = 0.0;
+				for (int b = 2 * j; b <= std::min(2 * j + 1, this->Source->Size[1] - 1); b++)
+				{
+					for (int a = 2 * i; a <= std::min(2 * i + 1, this->Source->Size[0] - 1); a++)
+					{
+						double w, m, m2;
+						this->Source->Get(a, b, w, m, m2);
+						weight += w;
+						sum += w * m;
+						sumOfSquares += w * m2;
+					}
+				}
+				vtkIdType k = static_cast<vtkIdType>(j) * nx + i;
+				this->Level->Mean[k] = static_cast<float>(sum / weight);
+				this->Level->MeanOfSquares[k] = static_cast<float>(sumOfSquares / weight);
+			}
+		}
+	}
+};
+
+template <class TSource>
+void vtkEllipseProgressiveReduce(const TSource &source, vtkEllipseProgressiveLevel &level)
+{
+	vtkEllipseProgressiveReduceFunctor<TSource> functor;
+	functor.Source = &source;
+	functor.Level = &level;
+	vtkSMPTools::For(0, level.Size[1], functor);
+}
+
+template <class T>
+void vtkEllipseProgressiveReduceImage(const T *base, const vtkIdType increments[3],
+	const int size[2], vtkEllipseProgressiveLevel &level)
+{
+	vtkEllipseProgressiveImageSource<T> source;
+	source.Base = base;
+	source.Increments[0] = increments[0];
+	source.Increments[1] = increments[1];
+	source.Size[0] = size[0];
+	source.Size[1] = size[1];
+	vtkEllipseProgressiveReduce(source, level);
+}
+
+//-------------------------------------------------------------------------
+// Accumulate the blocks of a level whose center is inside the ellipse. Rows
+// are skipped once the computation is aborted.
+template <class TSource>
+class vtkEllipseProgressiveFunctor
+{
+public:
+	const TSource *Source;
+	vtkEllipseScanline Scanline;
+	const std::atomic<bool> *Abort;
+	vtkSMPThreadLocal<vtkEllipseStatisticsAccumulator> Accumulator;
+
+	void Initialize()
+	{
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		this->AddRows(begin, end, this->Accumulator.Local());
+	}
+
+	void AddRows(vtkIdType begin, vtkIdType end, vtkEllipseStatisticsAccumulator &acc) const
+	{
+		for (vtkIdType j = begin; j < end && !this->Abort->load(std::memory_order_relaxed); j++)
+		{
+			int i0, i1;
+			if (!this->Scanline.GetSpan(static_cast<int>(j), i0, i1))
+			{
+				continue;
+			}
+			i0 = std::max(i0, 0);
+			i1 = std::min(i1, this->Source->Size[0] - 1);
+			for (int i = i0; i <= i1; i++)
+			{
+				double w, m, m2;
+				this->Source->Get(i, static_cast<int>(j), w, m, m2);
+				acc.Weight += w;
+				acc.Sum += w * m;
+				acc.SumOfSquares += w * m2;
+				acc.Minimum = std::min(acc.Minimum, m);
+				acc.Maximum = std::max(acc.Maximum, m);
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+// Reproducible mode: a number of row blocks that only depends on the number
+// of rows, each accumulated sequentially and merged in index order
+template <class TSource>
+class vtkEllipseProgressiveBlockFunctor
+{
+public:
+	const vtkEllipseProgressiveFunctor<TSource> *Rows;
+	vtkIdType FirstRow;
+	vtkIdType NumberOfRows;
+	std::vector<vtkEllipseStatisticsAccumulator> Blocks;
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		const vtkIdType n = static_cast<vtkIdType>(this->Blocks.size());
+		for (vtkIdType b = begin; b < end; b++)
+		{
+			this->Rows->AddRows(this->FirstRow + this->NumberOfRows * b / n,
+				this->FirstRow + this->NumberOfRows * (b + 1) / n, this->Blocks[b]);
+		}
+	}
+};
+
+template <class TSource>
+void vtkEllipseProgressiveAccumulate(const TSource &source, const vtkEllipseScanline &scanline,
+	const std::atomic<bool> &abort, bool reproducible, vtkEllipseStatisticsAccumulator &result)
+{
+	int j0, j1;
+	scanline.GetRowRange(j0, j1);
+	j0 = std::max(j0, 0);
+	j1 = std::min(j1, source.Size[1] - 1);
+	if (j0 > j1)
+	{
+		return;
+	}
+	vtkEllipseProgressiveFunctor<TSource> functor;
+	functor.Source = &source;
+	functor.Scanline = scanline;
+	functor.Abort = &abort;
+	if (reproducible)
+	{
+		// At most 64 blocks, as vtkEllipseProfile
+		vtkEllipseProgressiveBlockFunctor<TSource> blocks;
+		blocks.Rows = &functor;
+		blocks.FirstRow = j0;
+		blocks.NumberOfRows = j1 - j0 + 1;
+		blocks.Blocks.resize(std::min<vtkIdType>(64, std::max<vtkIdType>(1,
+			blocks.NumberOfRows / vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE)));
+		vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.Blocks.size()), 1, blocks);
+		for (const auto &block : blocks.Blocks)
+		{
+			result.Merge(block);
+		}
+		return;
+	}
+	vtkSMPTools::For(j0, j1 + 1, functor);
+	for (auto it = functor.Accumulator.begin(); it != functor.Accumulator.end(); ++it)
+	{
+		result.Merge(*it);
+	}
+}
+
+template <class T>
+void vtkEllipseProgressiveAccumulateImage(const T *base, const vtkIdType increments[3],
+	const int size[2], const vtkEllipseScanline &scanline, const std::atomic<bool> &abort,
+	bool reproducible, vtkEllipseStatisticsAccumulator &result)
+{
+	vtkEllipseProgressiveImageSource<T> source;
+	source.Base = base;
+	source.Increments[0] = increments[0];
+	source.Increments[1] = increments[1];
+	source.Size[0] = size[0];
+	source.Size[1] = size[1];
+	vtkEllipseProgressiveAccumulate(source, scanline, abort, reproducible, result);
+}
+}
+
+//-------------------------------------------------------------------------
+class vtkEllipseProgressiveStatistics::vtkInternals
+{
+public:
+	// The pyramid of the slice, Levels[l - 1] being level l, and what it
+	// was built from
+	std::vector<vtkEllipseProgressiveLevel> Levels;
+	vtkImageData *Image = nullptr;
+	vtkMTimeType ImageMTime = 0;
+	int Slice = 0;
+	int Component = 0;
+
+	// The slice
+	const void *Base = nullptr;
+	int ScalarType = 0;
+	vtkIdType Increments[3];
+	int Size[2];
+
+	// The ellipse in index coordinates of the slice, and the parameters of
+	// the current results
+	double Center[2];
+	double Radius[2];
+	vtkMTimeType ResultMTime = 0;
+
+	// Copy of the flag, only set by Prepare() while no worker runs
+	bool Reproducible = false;
+
+	// Refinement
+	std::thread Worker;
+	std::atomic<bool> Abort{ false };
+	std::mutex Mutex;
+	std::deque<std::pair<int, vtkEllipseStatisticsAccumulator> > Pending;
+	bool Finished = false;
+	bool Refining = false;
+	int Generation = 0;
+	vtkMTimeType RefinementMTime = 0;
+
+	// Widget and timers
+	unsigned long WidgetTags[3];
+	vtkRenderWindowInteractor *Interactor = nullptr;
+	unsigned long InteractorTag = 0;
+	int PollTimer = -1;
+	int PauseTimer = -1;
+
+	// Size of level l
+	int GetLevelSize(int l, int axis) const
+	{
+		return (this->Size[axis] + (1 << l) - 1) >> l;
+	}
+
+	void BuildLevels(int levels)
+	{
+		while (static_cast<int>(this->Levels.size()) < levels)
+		{
+			int l = static_cast<int>(this->Levels.size()) + 1;
+			vtkEllipseProgressiveLevel level;
+			level.Size[0] = this->GetLevelSize(l, 0);
+			level.Size[1] = this->GetLevelSize(l, 1);
+			level.Scale = 1 << l;
+			level.Mean.resize(static_cast<size_t>(level.Size[0]) * level.Size[1]);
+			level.MeanOfSquares.resize(level.Mean.size());
+			if (l == 1)
+			{
+				switch (this->ScalarType)
+				{
+					vtkTemplateMacro(vtkEllipseProgressiveReduceImage(
+						static_cast<const VTK_TT*>(this->Base), this->Increments, this->Size, level));
+				}
+			}
+			else
+			{
+				this->Reduce(this->Levels.back(), level);
+			}
+			this->Levels.push_back(std::move(level));
+		}
+	}
+
+	void Reduce(const vtkEllipseProgressiveLevel &fine, vtkEllipseProgressiveLevel &coarse) const
+	{
+		vtkEllipseProgressiveLevelSource source;
+		source.Level = &fine;
+		source.BaseSize[0] = this->Size[0];
+		source.BaseSize[1] = this->Size[1];
+		source.Size[0] = fine.Size[0];
+		source.Size[1] = fine.Size[1];
+		vtkEllipseProgressiveReduce(source, coarse);
+	}
+
+	// Statistics of the ellipse on level l. Safe to call from the worker
+	// thread once the levels are built.
+	void Compute(int l, const double center[2], const double radius[2],
+		vtkEllipseStatisticsAccumulator &result) const
+	{
+		// Pixel i of level l is centered on image pixel i * s + (s - 1) / 2
+		double s = static_cast<double>(1 << l);
+		double c[2] = { (center[0] - 0.5 * (s - 1.0)) / s, (center[1] - 0.5 * (s - 1.0)) / s };
+		double r[2] = { radius[0] / s, radius[1] / s };
+		vtkEllipseScanline scanline(c, r);
+		if (!scanline.IsValid())
+		{
+			return;
+		}
+		if (l == 0)
+		{
+			switch (this->ScalarType)
+			{
+				vtkTemplateMacro(vtkEllipseProgressiveAccumulateImage(
+					static_cast<const VTK_TT*>(this->Base), this->Increments, this->Size,
+					scanline, this->Abort, this->Reproducible, result));
+			}
+			return;
+		}
+		const vtkEllipseProgressiveLevel &level = this->Levels[l - 1];
+		vtkEllipseProgressiveLevelSource source;
+		source.Level = &level;
+		source.BaseSize[0] = this->Size[0];
+		source.BaseSize[1] = this->Size[1];
+		source.Size[0] = level.Size[0];
+		source.Size[1] = level.Size[1];
+		vtkEllipseProgressiveAccumulate(source, scanline, this->Abort, this->Reproducible, result);
+	}
+};
+
+//-------------------------------------------------------------------------
+vtkEllipseProgressiveStatistics::vtkEllipseProgressiveStatistics()
+{
+	this->Input = nullptr;
+	this->Center[0] = this->Center[1] = 0.0;
+	this->Radius[0] = this->Radius[1] = 1.0;
+	this->Slice = 0;
+	this->Component = 0;
+	this->NumberOfLevels = 8;
+	this->EstimateBudget = 65536;
+	this->PauseDuration = 250;
+	this->Reproducible = 0;
+	this->Widget = nullptr;
+	this->Level = -1;
+	this->CountErrorBound = 0.0;
+	this->MeanErrorBound = 0.0;
+	this->PixelArea = 1.0;
+	this->Internals = new vtkInternals;
+	this->EventCallbackCommand = vtkCallbackCommand::New();
+	this->EventCallbackCommand->SetClientData(this);
+	this->EventCallbackCommand->SetCallback(vtkEllipseProgressiveStatistics::ProcessEvents);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseProgressiveStatistics::~vtkEllipseProgressiveStatistics()
+{
+	this->AbortRefinement();
+	this->StopTimer(this->Internals->PauseTimer);
+	if (this->Internals->Interactor)
+	{
+		this->Internals->Interactor->RemoveObserver(this->Internals->InteractorTag);
+	}
+	this->SetWidget(nullptr);
+	this->SetInputData(nullptr);
+	delete this->Internals;
+	this->EventCallbackCommand->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::SetInputData(vtkImageData *image)
+{
+	if (image != this->Input)
+	{
+		this->AbortRefinement();
+	}
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::SetWidget(vtkEllipseWidget *widget)
+{
+	if (widget == this->Widget)
+	{
+		return;
+	}
+	vtkInternals *internals = this->Internals;
+	if (this->Widget)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			this->Widget->RemoveObserver(internals->WidgetTags[i]);
+		}
+		this->Widget->UnRegister(this);
+	}
+	this->Widget = widget;
+	if (widget)
+	{
+		widget->Register(this);
+		internals->WidgetTags[0] = widget->AddObserver(vtkCommand::StartInteractionEvent,
+			this->EventCallbackCommand);
+		internals->WidgetTags[1] = widget->AddObserver(vtkCommand::InteractionEvent,
+			this->EventCallbackCommand);
+		internals->WidgetTags[2] = widget->AddObserver(vtkCommand::EndInteractionEvent,
+			this->EventCallbackCommand);
+	}
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::SetCorners(const double p1[2], const double p2[2])
+{
+	this->SetCenter(0.5 * (p1[0] + p2[0]), 0.5 * (p1[1] + p2[1]));
+	this->SetRadius(0.5 * fabs(p2[0] - p1[0]), 0.5 * fabs(p2[1] - p1[1]));
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseProgressiveStatistics::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Input)
+	{
+		mTime = std::max(mTime, this->Input->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+// Check the input, discard the pyramid if it is out of date, and map the
+// ellipse to index coordinates of the slice
+bool vtkEllipseProgressiveStatistics::Prepare()
+{
+	vtkInternals *internals = this->Internals;
+	this->Result = vtkEllipseStatisticsAccumulator();
+	this->Level = -1;
+
+	vtkDataArray *scalars = this->Input ? this->Input->GetPointData()->GetScalars() : nullptr;
+	if (!scalars)
+	{
+		vtkErrorMacro(<< "No input scalars to compute statistics on");
+		return false;
+	}
+	if (this->Component >= scalars->GetNumberOfComponents())
+	{
+		vtkErrorMacro(<< "Component " << this->Component << " is out of range");
+		return false;
+	}
+	int extent[6];
+	this->Input->GetExtent(extent);
+	if (this->Slice < extent[4] || this->Slice > extent[5])
+	{
+		vtkErrorMacro(<< "Slice " << this->Slice << " is outside of the input extent");
+		return false;
+	}
+
+	// A modified image, slice or component invalidates the pyramid
+	if (internals->Image != this->Input || internals->ImageMTime != this->Input->GetMTime() ||
+		internals->Slice != this->Slice || internals->Component != this->Component)
+	{
+		internals->Levels.clear();
+		internals->Image = this->Input;
+		internals->ImageMTime = this->Input->GetMTime();
+		internals->Slice = this->Slice;
+		internals->Component = this->Component;
+		internals->Base = static_cast<const char*>(
+			this->Input->GetScalarPointer(extent[0], extent[2], this->Slice)) +
+			this->Component * scalars->GetDataTypeSize();
+		internals->ScalarType = scalars->GetDataType();
+		this->Input->GetIncrements(internals->Increments);
+		internals->Size[0] = extent[1] - extent[0] + 1;
+		internals->Size[1] = extent[3] - extent[2] + 1;
+	}
+
+	double origin[3], spacing[3];
+	this->Input->GetOrigin(origin);
+	this->Input->GetSpacing(spacing);
+	this->PixelArea = fabs(spacing[0] * spacing[1]);
+	for (int i = 0; i < 2; i++)
+	{
+		internals->Center[i] = (this->Center[i] - origin[i]) / spacing[i] - extent[2 * i];
+		internals->Radius[i] = this->Radius[i] / fabs(spacing[i]);
+	}
+	internals->Reproducible = this->Reproducible != 0;
+	internals->ResultMTime = this->GetMTime();
+	return true;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::Estimate()
+{
+	vtkEllipseTraceScopeMacro("vtkEllipseProgressiveStatistics::Estimate");
+
+	this->AbortRefinement();
+	if (!this->Prepare())
+	{
+		return;
+	}
+
+	// The finest level whose pixels in the ROI fit in the budget
+	vtkInternals *internals = this->Internals;
+	double pixels = vtkMath::Pi() * internals->Radius[0] * internals->Radius[1];
+	int level = 0;
+	while (level < this->NumberOfLevels && pixels > this->EstimateBudget &&
+		internals->GetLevelSize(level + 1, 0) > 1 && internals->GetLevelSize(level + 1, 1) > 1)
+	{
+		pixels /= 4.0;
+		level++;
+	}
+	internals->BuildLevels(level);
+
+	vtkEllipseStatisticsAccumulator result;
+	internals->Compute(level, internals->Center, internals->Radius, result);
+	if (level == 0)
+	{
+		this->ComputeTime.Modified();
+	}
+	this->SetLevelResult(level, result);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::SetLevelResult(int level,
+	const vtkEllipseStatisticsAccumulator &result)
+{
+	this->Result = result;
+	this->Level = level;
+
+	// Only the blocks crossing the contour may be misclassified: they lie
+	// within half a block diagonal of it
+	const double *r = this->Internals->Radius;
+	double perimeter = vtkMath::Pi() *
+		(3.0 * (r[0] + r[1]) - sqrt((3.0 * r[0] + r[1]) * (r[0] + 3.0 * r[1])));
+	double band = level > 0 ? perimeter * (1 << level) * 0.5 * sqrt(2.0) : 0.0;
+	this->CountErrorBound = band;
+	this->MeanErrorBound = 0.0;
+	if (level > 0 && result.Weight > 0.0)
+	{
+		this->MeanErrorBound = std::min(band / result.Weight, 1.0) *
+			(result.Maximum - result.Minimum);
+	}
+
+	int l = level;
+	this->InvokeEvent(LevelCompletedEvent, &l);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::StartRefinement()
+{
+	vtkInternals *internals = this->Internals;
+	this->AbortRefinement();
+	if (this->Level < 0 || this->GetMTime() != internals->ResultMTime)
+	{
+		this->Estimate();
+	}
+	if (this->Level <= 0)
+	{
+		return;
+	}
+
+	double center[2] = { internals->Center[0], internals->Center[1] };
+	double radius[2] = { internals->Radius[0], internals->Radius[1] };
+	int first = this->Level - 1;
+	internals->Refining = true;
+	internals->Finished = false;
+	internals->RefinementMTime = this->GetMTime();
+	internals->Worker = std::thread([internals, center, radius, first]()
+	{
+		for (int level = first; level >= 0; level--)
+		{
+			vtkEllipseStatisticsAccumulator result;
+			internals->Compute(level, center, radius, result);
+			if (internals->Abort)
+			{
+				break;
+			}
+			std::lock_guard<std::mutex> lock(internals->Mutex);
+			internals->Pending.push_back(std::make_pair(level, result));
+		}
+		std::lock_guard<std::mutex> lock(internals->Mutex);
+		internals->Finished = true;
+	});
+
+	// Poll the results from the event loop when following a widget
+	if (vtkRenderWindowInteractor *interactor = this->ObserveInteractor())
+	{
+		internals->PollTimer = interactor->CreateRepeatingTimer(30);
+	}
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseProgressiveStatistics::PollRefinement()
+{
+	vtkInternals *internals = this->Internals;
+	if (!internals->Refining)
+	{
+		return 0;
+	}
+	if (this->GetMTime() != internals->RefinementMTime)
+	{
+		this->AbortRefinement();
+		return 0;
+	}
+
+	std::deque<std::pair<int, vtkEllipseStatisticsAccumulator> > results;
+	bool finished;
+	{
+		std::lock_guard<std::mutex> lock(internals->Mutex);
+		results.swap(internals->Pending);
+		finished = internals->Finished;
+	}
+
+	// An observer may start over, discarding the remaining levels
+	int generation = internals->Generation;
+	for (const auto &result : results)
+	{
+		if (result.first == 0)
+		{
+			this->ComputeTime.Modified();
+		}
+		this->SetLevelResult(result.first, result.second);
+		if (internals->Generation != generation)
+		{
+			return internals->Refining ? 1 : 0;
+		}
+	}
+
+	if (finished)
+	{
+		if (internals->Worker.joinable())
+		{
+			internals->Worker.join();
+		}
+		internals->Refining = false;
+		this->StopTimer(internals->PollTimer);
+		return 0;
+	}
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::WaitForRefinement()
+{
+	// PollRefinement() only joins a worker that is still joinable
+	if (this->Internals->Refining)
+	{
+		this->Internals->Worker.join();
+		this->PollRefinement();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::AbortRefinement()
+{
+	vtkInternals *internals = this->Internals;
+	if (internals->Worker.joinable())
+	{
+		internals->Abort = true;
+		internals->Worker.join();
+		internals->Abort = false;
+	}
+	internals->Pending.clear();
+	internals->Refining = false;
+	internals->Generation++;
+	this->StopTimer(internals->PollTimer);
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseProgressiveStatistics::GetRefining()
+{
+	return this->Internals->Refining ? 1 : 0;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::Update()
+{
+	if (this->GetMTime() <= this->ComputeTime && this->Level == 0)
+	{
+		return;
+	}
+	this->AbortRefinement();
+	if (!this->Prepare())
+	{
+		return;
+	}
+	vtkEllipseStatisticsAccumulator result;
+	this->Internals->Compute(0, this->Internals->Center, this->Internals->Radius, result);
+	this->ComputeTime.Modified();
+	this->SetLevelResult(0, result);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::StopTimer(int &timerId)
+{
+	if (timerId >= 0 && this->Internals->Interactor)
+	{
+		this->Internals->Interactor->DestroyTimer(timerId);
+	}
+	timerId = -1;
+}
+
+//-------------------------------------------------------------------------
+// Watch the timers of the interactor of the widget
+vtkRenderWindowInteractor *vtkEllipseProgressiveStatistics::ObserveInteractor()
+{
+	vtkInternals *internals = this->Internals;
+	vtkRenderWindowInteractor *interactor = this->Widget ? this->Widget->GetInteractor() : nullptr;
+	if (interactor && interactor != internals->Interactor)
+	{
+		if (internals->Interactor)
+		{
+			internals->Interactor->RemoveObserver(internals->InteractorTag);
+		}
+		internals->Interactor = interactor;
+		internals->InteractorTag = interactor->AddObserver(vtkCommand::TimerEvent,
+			this->EventCallbackCommand);
+	}
+	return interactor;
+}
+
+//-------------------------------------------------------------------------
+// Read the ellipse from the world corners of the representation
+void vtkEllipseProgressiveStatistics::FollowWidget()
+{
+	vtkEllipseRepresentation *rep = this->Widget->GetEllipseRepresentation();
+	if (rep && rep->GetAnchorMode() == vtkEllipseRepresentation::ANCHOR_WORLD)
+	{
+		double w1[3], w2[3];
+		rep->GetWorldCorners(w1, w2);
+		this->SetCorners(w1, w2);
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::ProcessEvents(vtkObject *vtkNotUsed(caller),
+	unsigned long event, void *clientdata, void *calldata)
+{
+	vtkEllipseProgressiveStatistics *self =
+		reinterpret_cast<vtkEllipseProgressiveStatistics*>(clientdata);
+	vtkInternals *internals = self->Internals;
+
+	switch (event)
+	{
+	case vtkCommand::StartInteractionEvent:
+		self->AbortRefinement();
+		self->StopTimer(internals->PauseTimer);
+		break;
+	case vtkCommand::InteractionEvent:
+	{
+		// A new estimate, and a refinement if the widget stays still
+		self->StopTimer(internals->PauseTimer);
+		self->FollowWidget();
+		self->Estimate();
+		vtkRenderWindowInteractor *interactor = self->ObserveInteractor();
+		if (interactor && self->Level > 0)
+		{
+			internals->PauseTimer = interactor->CreateOneShotTimer(self->PauseDuration);
+		}
+		break;
+	}
+	case vtkCommand::EndInteractionEvent:
+		self->StopTimer(internals->PauseTimer);
+		self->FollowWidget();
+		if (!internals->Refining || self->GetMTime() != internals->RefinementMTime)
+		{
+			self->StartRefinement();
+		}
+		break;
+	case vtkCommand::TimerEvent:
+	{
+		int timerId = calldata ? *static_cast<int*>(calldata) : -1;
+		if (timerId == internals->PollTimer)
+		{
+			self->PollRefinement();
+		}
+		else if (timerId == internals->PauseTimer)
+		{
+			internals->PauseTimer = -1;
+			if (!internals->Refining)
+			{
+				self->StartRefinement();
+			}
+		}
+		break;
+	}
+	}
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseProgressiveStatistics::GetStandardDeviation()
+{
+	return sqrt(this->Result.GetVariance());
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseProgressiveStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Center: (" << this->Center[0] << ", " << this->Center[1] << ")\n";
+	os << indent << "Radius: (" << this->Radius[0] << ", " << this->Radius[1] << ")\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Component: " << this->Component << "\n";
+	os << indent << "Number Of Levels: " << this->NumberOfLevels << "\n";
+	os << indent << "Estimate Budget: " << this->EstimateBudget << "\n";
+	os << indent << "Pause Duration: " << this->PauseDuration << "\n";
+	os << indent << "Reproducible: " << (this->Reproducible ? "On\n" : "Off\n");
+	os << indent << "Widget: " << this->Widget << "\n";
+	os << indent << "Refining: " << (this->Internals->Refining ? "On\n" : "Off\n");
+	os << indent << "Level: " << this->Level << "\n";
+	os << indent << "Count: " << this->GetCount() << " +/- " << this->CountErrorBound << "\n";
+	os << indent << "Mean: " << this->GetMean() << " +/- " << this->MeanErrorBound << "\n";
+	os << indent << "Standard Deviation: " << this->GetStandardDeviation() << "\n";
+	os << indent << "Minimum: " << this->GetMinimum() << "\n";
+	os << indent << "Maximum: " << this->GetMaximum() << "\n";
+}
@@ -0,0 +1,282 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseProgressiveStatistics.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseProgressiveStatistics
+* @brief   approximate ROI statistics during a drag, refined in the background
+*
+* vtkEllipseProgressiveStatistics measures an image slice inside an ellipse
+* like vtkEllipseStatistics in BINARY mode, but in steps. Estimate() reads a
+* coarse level of an image pyramid, chosen so that at most EstimateBudget
+* pyramid pixels are read, and returns approximate statistics together with
+* error bounds. StartRefinement() then recomputes the statistics on every
+* finer level down to the full resolution image on a background thread.
+*
+* Each pixel of level l of the pyramid holds the mean and the mean of the
+* squares of the 2^l x 2^l image pixels it covers, so the sums of a level
+* are exact except along the contour, where whole blocks are in or out of
+* the ROI. The pyramid of a slice is built lazily, one level at a time, the
+* first time a level is needed, and is kept until the image, slice or
+* component changes.
+*
+* Completed levels are delivered on the calling thread by PollRefinement(),
+* which invokes a LevelCompletedEvent with the level (an int) as call data;
+* Estimate() invokes the same event. Given a vtkEllipseWidget with a world
+* anchored representation, the statistics follow the widget: every
+* InteractionEvent aborts the refinement and makes a new estimate, and the
+* refinement starts once the drag has paused for PauseDuration milliseconds
+* or on the EndInteractionEvent, with the results polled by a timer of the
+* interactor of the widget.
+*
+* The input must not be modified during a refinement; setting a new input
+* or calling Estimate() or Update() aborts it first.
+*
+* @sa
+* vtkEllipseStatistics vtkEllipseWidget
+*/
+
+#ifndef vtkEllipseProgressiveStatistics_h
+#define vtkEllipseProgressiveStatistics_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkCommand.h" // For LevelCompletedEvent
+#include "vtkEllipseStatistics.h" // For vtkEllipseStatisticsAccumulator
+
+class vtkImageData;
+class vtkEllipseWidget;
+class vtkCallbackCommand;
+class vtkRenderWindowInteractor;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseProgressiveStatistics : public vtkObject
+class vtkEllipseProgressiveStatistics : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseProgressiveStatistics *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseProgressiveStatistics, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	/**
+	* Invoked with the level (an int, 0 for the full resolution) as call
+	* data when statistics are estimated or a refinement level completes.
+	*/
+	enum { LevelCompletedEvent = vtkCommand::UserEvent + 4800 };
+
+	//@{
+	/**
+	* Specify the image to measure.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipse by its center and semi-axis lengths along x and y,
+	* in world coordinates.
+	*/
+	vtkSetVector2Macro(Center, double);
+	vtkGetVector2Macro(Center, double);
+	vtkSetVector2Macro(Radius, double);
+	vtkGetVector2Macro(Radius, double);
+	//@}
+
+	/**
+	* Convenience method to specify the ellipse by two opposite corners of its
+	* bounding rectangle in world coordinates.
+	*/
+	void SetCorners(const double p1[2], const double p2[2]);
+
+	//@{
+	/**
+	* Specify the slice (the k index, in extent coordinates) and the scalar
+	* component to measure. Both default to 0.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+	vtkGetMacro(Component, int);
+	//@}
+
+	//@{
+	/**
+	* Maximum number of coarse levels of the pyramid. 8 by default.
+	*/
+	vtkSetClampMacro(NumberOfLevels, int, 1, 16);
+	vtkGetMacro(NumberOfLevels, int);
+	//@}
+
+	//@{
+	/**
+	* Approximate maximum number of pixels read by Estimate(). The finest
+	* level of the pyramid whose pixels in the ROI fit in the budget is used.
+	* 65536 by default.
+	*/
+	vtkSetClampMacro(EstimateBudget, int, 64, VTK_INT_MAX);
+	vtkGetMacro(EstimateBudget, int);
+	//@}
+
+	//@{
+	/**
+	* Time, in milliseconds, the widget must stay still during a drag before
+	* the refinement starts. 250 by default.
+	*/
+	vtkSetClampMacro(PauseDuration, int, 1, VTK_INT_MAX);
+	vtkGetMacro(PauseDuration, int);
+	//@}
+
+	//@{
+	/**
+	* Make the results of every level bit for bit reproducible whatever the
+	* number of threads, as vtkEllipseStatistics::SetReproducible(): the rows
+	* of the ROI are split into a fixed number of blocks (one per
+	* REPRODUCIBLE_CHUNK_SIZE rows, at most 64) summed sequentially and merged
+	* in index order. Taken into account by the next Estimate() or Update().
+	* Off by default.
+	*/
+	vtkSetMacro(Reproducible, vtkTypeBool);
+	vtkGetMacro(Reproducible, vtkTypeBool);
+	vtkBooleanMacro(Reproducible, vtkTypeBool);
+	//@}
+
+	//@{
+	/**
+	* Specify a widget to follow. Its representation must be world anchored.
+	*/
+	virtual void SetWidget(vtkEllipseWidget *widget);
+	vtkGetObjectMacro(Widget, vtkEllipseWidget);
+	//@}
+
+	/**
+	* Compute approximate statistics on a coarse level of the pyramid and
+	* invoke a LevelCompletedEvent. Small ROIs are measured exactly.
+	*/
+	void Estimate();
+
+	/**
+	* Start refining the last estimate on a background thread, one level at a
+	* time down to the full resolution. Results are delivered by
+	* PollRefinement().
+	*/
+	void StartRefinement();
+
+	/**
+	* Deliver the levels completed since the last call, each with a
+	* LevelCompletedEvent. Return 1 while the refinement is in progress. The
+	* results are discarded if the parameters were modified since the
+	* refinement started. Called by a timer when following a widget.
+	*/
+	int PollRefinement();
+
+	/**
+	* Wait for the refinement to complete and deliver its levels.
+	*/
+	void WaitForRefinement();
+
+	/**
+	* Stop the refinement, discarding the levels not delivered yet.
+	*/
+	void AbortRefinement();
+
+	/**
+	* Return 1 while a refinement is in progress.
+	*/
+	int GetRefining();
+
+	/**
+	* Compute the exact statistics (level 0) on the calling thread if the
+	* input or the parameters changed since the last exact computation.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* Results of the last estimate or completed level. Level is the level of
+	* the pyramid they were computed on (-1 before any computation, 0 for
+	* exact results). On coarse levels, Minimum and Maximum are those of the
+	* block means, within the true range.
+	*/
+	vtkGetMacro(Level, int);
+	double GetCount() { return this->Result.Weight; }
+	double GetArea() { return this->Result.Weight * this->PixelArea; }
+	double GetMean() { return this->Result.GetMean(); }
+	double GetVariance() { return this->Result.GetVariance(); }
+	double GetStandardDeviation();
+	double GetMinimum() { return this->Result.Weight > 0.0 ? this->Result.Minimum : 0.0; }
+	double GetMaximum() { return this->Result.Weight > 0.0 ? this->Result.Maximum : 0.0; }
+	//@}
+
+	//@{
+	/**
+	* Estimated bounds of the errors of the count and of the mean of the last
+	* results, from the number of pixels of the blocks crossing the contour
+	* and the range of the block means. 0 for exact results.
+	*/
+	vtkGetMacro(CountErrorBound, double);
+	vtkGetMacro(MeanErrorBound, double);
+	//@}
+
+	/**
+	* Return the MTime also considering the input image.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipseProgressiveStatistics();
+	~vtkEllipseProgressiveStatistics() override;
+
+	vtkImageData *Input;
+	double Center[2];
+	double Radius[2];
+	int Slice;
+	int Component;
+	int NumberOfLevels;
+	int EstimateBudget;
+	int PauseDuration;
+	vtkTypeBool Reproducible;
+	vtkEllipseWidget *Widget;
+
+	vtkEllipseStatisticsAccumulator Result;
+	int Level;
+	double CountErrorBound;
+	double MeanErrorBound;
+	double PixelArea;
+	vtkTimeStamp ComputeTime;
+
+	class vtkInternals;
+	vtkInternals *Internals;
+	bool Prepare();
+
+	// Follow the widget and the timers of its interactor
+	vtkCallbackCommand *EventCallbackCommand;
+	static void ProcessEvents(vtkObject *caller, unsigned long event,
+		void *clientdata, void *calldata);
+	void FollowWidget();
+	vtkRenderWindowInteractor *ObserveInteractor();
+	void StopTimer(int &timerId);
+
+	// Set the results of a level and invoke the LevelCompletedEvent
+	void SetLevelResult(int level, const vtkEllipseStatisticsAccumulator &result);
+
+private:
+	vtkEllipseProgressiveStatistics(const vtkEllipseProgressiveStatistics&) = delete;
+	void operator=(const vtkEllipseProgressiveStatistics&) = delete;
+};
+
+#endif
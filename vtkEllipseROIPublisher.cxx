@@ -0,0 +1,374 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseROIPublisher.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseROIPublisher.h"
+#include "vtkEllipseROISharedMemory.h"
+#include "vtkEllipseWidget.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkEllipseStatistics.h"
+#include "vtkEllipseTrace.h"
+#include "vtkCallbackCommand.h"
+#include "vtkObjectFactory.h"
+
+#include <cmath>
+#include <string>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <ctime>
+#endif
+
+vtkStandardNewMacro(vtkEllipseROIPublisher);
+
+//-------------------------------------------------------------------------
+class vtkEllipseROIPublisher::vtkInternals
+{
+public:
+#ifndef _WIN32
+	// The mapped segment and the name it was created with
+	vtkEllipseROIRingHeader *Header = nullptr;
+	vtkEllipseROISlot *Slots = nullptr;
+	size_t Size = 0;
+	std::string Name;
+	int FileDescriptor = -1; // kept to recognize the segment in Close()
+#endif
+	vtkTypeUInt64 Sequence = 0;
+};
+
+#ifndef _WIN32
+//-------------------------------------------------------------------------
+// Mark a segment left under name closed, so that its readers reopen the
+// name, and remove the name. Return 1 if the segment was not closed yet.
+static int vtkEllipseROIPublisherRetire(const char *name)
+{
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+	{
+		return 0;
+	}
+	int wasOpen = 0;
+	struct stat status;
+	if (fstat(fd, &status) == 0 &&
+		static_cast<size_t>(status.st_size) >= sizeof(vtkEllipseROIRingHeader))
+	{
+		void *address = mmap(nullptr, sizeof(vtkEllipseROIRingHeader),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (address != MAP_FAILED)
+		{
+			vtkEllipseROIRingHeader *header = static_cast<vtkEllipseROIRingHeader*>(address);
+			if (header->Magic.load(std::memory_order_acquire) == VTK_ELLIPSE_ROI_MAGIC)
+			{
+				wasOpen = header->Closed.exchange(1, std::memory_order_acq_rel) == 0;
+			}
+			munmap(address, sizeof(vtkEllipseROIRingHeader));
+		}
+	}
+	close(fd);
+	shm_unlink(name);
+	return wasOpen;
+}
+
+//-------------------------------------------------------------------------
+// Return 1 if name still refers to the segment open as fd
+static int vtkEllipseROIPublisherOwns(const char *name, int fd)
+{
+	int named = shm_open(name, O_RDONLY, 0);
+	if (named < 0)
+	{
+		return 0;
+	}
+	struct stat own, other;
+	int same = fstat(fd, &own) == 0 && fstat(named, &other) == 0 &&
+		own.st_dev == other.st_dev && own.st_ino == other.st_ino;
+	close(named);
+	return same;
+}
+#endif
+
+//-------------------------------------------------------------------------
+vtkEllipseROIPublisher::vtkEllipseROIPublisher()
+{
+	this->Name = nullptr;
+	this->SetName("/vtkEllipseROI");
+	this->NumberOfSlots = 64;
+	this->Widget = nullptr;
+	this->Statistics = nullptr;
+	this->Internals = new vtkInternals;
+
+	this->EventCallbackCommand = vtkCallbackCommand::New();
+	this->EventCallbackCommand->SetClientData(this);
+	this->EventCallbackCommand->SetCallback(vtkEllipseROIPublisher::ProcessEvents);
+	this->WidgetTags[0] = this->WidgetTags[1] = 0;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseROIPublisher::~vtkEllipseROIPublisher()
+{
+	this->Close();
+	this->SetWidget(nullptr);
+	this->SetStatistics(nullptr);
+	this->SetName(nullptr);
+	delete this->Internals;
+	this->EventCallbackCommand->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseROIPublisher::SetWidget(vtkEllipseWidget *widget)
+{
+	if (widget == this->Widget)
+	{
+		return;
+	}
+	if (this->Widget)
+	{
+		this->Widget->RemoveObserver(this->WidgetTags[0]);
+		this->Widget->RemoveObserver(this->WidgetTags[1]);
+		this->Widget->UnRegister(this);
+	}
+	this->Widget = widget;
+	if (widget)
+	{
+		widget->Register(this);
+		this->WidgetTags[0] = widget->AddObserver(vtkCommand::InteractionEvent,
+			this->EventCallbackCommand);
+		this->WidgetTags[1] = widget->AddObserver(vtkCommand::EndInteractionEvent,
+			this->EventCallbackCommand);
+	}
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseROIPublisher::SetStatistics(vtkEllipseStatistics *statistics)
+{
+	vtkSetObjectBodyMacro(Statistics, vtkEllipseStatistics, statistics);
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseROIPublisher::Open()
+{
+	this->Close();
+#ifndef _WIN32
+	if (!this->Name || this->Name[0] != '/')
+	{
+		vtkErrorMacro(<< "The name of the shared memory must start with a /");
+		return 0;
+	}
+
+	// A segment already published under the name, by another publisher or
+	// one that did not close, is marked closed before it is replaced, so
+	// that its readers reopen the name and follow this publisher
+	const size_t size = sizeof(vtkEllipseROIRingHeader) +
+		static_cast<size_t>(this->NumberOfSlots) * sizeof(vtkEllipseROISlot);
+	int fd = shm_open(this->Name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0 && errno == EEXIST)
+	{
+		if (vtkEllipseROIPublisherRetire(this->Name))
+		{
+			vtkWarningMacro(<< "Replacing the shared memory " << this->Name
+				<< " of another publisher, whose readers now follow this one");
+		}
+		fd = shm_open(this->Name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	}
+	if (fd < 0)
+	{
+		vtkErrorMacro(<< "Cannot create the shared memory " << this->Name << ": "
+			<< strerror(errno));
+		return 0;
+	}
+	void *address = MAP_FAILED;
+	if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+	{
+		address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	int error = errno;
+	if (address == MAP_FAILED)
+	{
+		close(fd);
+		shm_unlink(this->Name);
+		vtkErrorMacro(<< "Cannot map the shared memory " << this->Name << ": "
+			<< strerror(error));
+		return 0;
+	}
+
+	// The new segment is zero filled: no record, and even slot versions.
+	// The magic number is written last, for readers opening it meanwhile.
+	vtkInternals *internals = this->Internals;
+	internals->Header = static_cast<vtkEllipseROIRingHeader*>(address);
+	internals->Slots = reinterpret_cast<vtkEllipseROISlot*>(internals->Header + 1);
+	internals->Size = size;
+	internals->Name = this->Name;
+	internals->FileDescriptor = fd;
+	internals->Sequence = 0;
+	internals->Header->Version = VTK_ELLIPSE_ROI_VERSION;
+	internals->Header->NumberOfSlots = static_cast<uint32_t>(this->NumberOfSlots);
+	internals->Header->RecordSize = sizeof(vtkEllipseROIRecord);
+	internals->Header->Magic.store(VTK_ELLIPSE_ROI_MAGIC, std::memory_order_release);
+	return 1;
+#else
+	vtkErrorMacro(<< "Publishing requires POSIX shared memory");
+	return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseROIPublisher::Close()
+{
+#ifndef _WIN32
+	vtkInternals *internals = this->Internals;
+	if (!internals->Header)
+	{
+		return;
+	}
+	internals->Header->Closed.store(1, std::memory_order_release);
+	munmap(internals->Header, internals->Size);
+
+	// Another publisher may have replaced the segment under the same name
+	if (vtkEllipseROIPublisherOwns(internals->Name.c_str(), internals->FileDescriptor))
+	{
+		shm_unlink(internals->Name.c_str());
+	}
+	close(internals->FileDescriptor);
+	internals->FileDescriptor = -1;
+	internals->Header = nullptr;
+	internals->Slots = nullptr;
+	internals->Size = 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseROIPublisher::IsOpen()
+{
+#ifndef _WIN32
+	return this->Internals->Header != nullptr;
+#else
+	return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+vtkTypeUInt64 vtkEllipseROIPublisher::GetLastSequence()
+{
+	return this->Internals->Sequence;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseROIPublisher::Publish()
+{
+#ifndef _WIN32
+	return this->Write(vtkEllipseROIRecord::EXPLICIT);
+#else
+	return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseROIPublisher::Write(unsigned int event)
+{
+#ifndef _WIN32
+	vtkEllipseTraceScopeMacro("vtkEllipseROIPublisher::Write");
+
+	vtkInternals *internals = this->Internals;
+	vtkEllipseRepresentation *rep = this->Widget ? this->Widget->GetEllipseRepresentation() : nullptr;
+	if (!internals->Header || !rep)
+	{
+		return 0;
+	}
+
+	vtkEllipseROIRecord record;
+	memset(&record, 0, sizeof(record));
+	record.Event = event;
+	if (rep->GetAnchorMode() == vtkEllipseRepresentation::ANCHOR_WORLD)
+	{
+		double w1[3], w2[3];
+		rep->GetWorldCorners(w1, w2);
+		record.Coordinates = vtkEllipseROIRecord::WORLD;
+		for (int i = 0; i < 2; i++)
+		{
+			record.Center[i] = 0.5 * (w1[i] + w2[i]);
+			record.Radius[i] = 0.5 * fabs(w2[i] - w1[i]);
+		}
+		record.Center[2] = 0.5 * (w1[2] + w2[2]);
+
+		vtkEllipseStatistics *statistics = this->Statistics;
+		if (statistics && statistics->GetInput())
+		{
+			statistics->SetCorners(w1, w2);
+			statistics->Update();
+			record.HasStatistics = 1;
+			record.Slice = statistics->GetSlice();
+			record.Count = statistics->GetCount();
+			record.Area = statistics->GetArea();
+			record.Mean = statistics->GetMean();
+			record.StandardDeviation = statistics->GetStandardDeviation();
+			record.Minimum = statistics->GetMinimum();
+			record.Maximum = statistics->GetMaximum();
+		}
+	}
+	else
+	{
+		double p1[2], p2[2];
+		if (!rep->GetDisplayCorners(p1, p2))
+		{
+			return 0;
+		}
+		record.Coordinates = vtkEllipseROIRecord::DISPLAY;
+		for (int i = 0; i < 2; i++)
+		{
+			record.Center[i] = 0.5 * (p1[i] + p2[i]);
+			record.Radius[i] = 0.5 * fabs(p2[i] - p1[i]);
+		}
+	}
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	record.Time = static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+	record.Sequence = ++internals->Sequence;
+
+	// Seqlock: the version of the slot is odd while its record is written
+	vtkEllipseROISlot *slot = internals->Slots +
+		(record.Sequence - 1) % internals->Header->NumberOfSlots;
+	uint64_t version = slot->Version.load(std::memory_order_relaxed);
+	slot->Version.store(version + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&slot->Record, &record, sizeof(record));
+	slot->Version.store(version + 2, std::memory_order_release);
+	internals->Header->Head.store(record.Sequence, std::memory_order_release);
+	return 1;
+#else
+	(void)event;
+	return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseROIPublisher::ProcessEvents(vtkObject *vtkNotUsed(caller),
+	unsigned long event, void *clientdata, void *vtkNotUsed(calldata))
+{
+#ifndef _WIN32
+	vtkEllipseROIPublisher *self = reinterpret_cast<vtkEllipseROIPublisher*>(clientdata);
+	self->Write(event == vtkCommand::EndInteractionEvent ?
+		vtkEllipseROIRecord::END_INTERACTION : vtkEllipseROIRecord::INTERACTION);
+#else
+	(void)event;
+	(void)clientdata;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseROIPublisher::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Name: " << (this->Name ? this->Name : "(none)") << "\n";
+	os << indent << "Number Of Slots: " << this->NumberOfSlots << "\n";
+	os << indent << "Widget: " << this->Widget << "\n";
+	os << indent << "Statistics: " << this->Statistics << "\n";
+	os << indent << "Open: " << (this->IsOpen() ? "Yes\n" : "No\n");
+	os << indent << "Last Sequence: " << this->Internals->Sequence << "\n";
+}
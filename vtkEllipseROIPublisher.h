@@ -0,0 +1,156 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseROIPublisher.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseROIPublisher
+* @brief   publish the live state of an ellipse ROI to other local processes
+*
+* vtkEllipseROIPublisher follows a vtkEllipseWidget and, on every
+* InteractionEvent and EndInteractionEvent, writes a versioned record of the
+* ellipse (center and semi-axes, in world coordinates for a world anchored
+* representation and in display coordinates otherwise) into a ring of
+* records in POSIX shared memory. Given a vtkEllipseStatistics, it is
+* updated on the ellipse first and its results are published too.
+*
+* Other processes on the same host read the records with the header only
+* vtkEllipseROISharedMemoryReader, which maps the segment and copies a
+* record with a seqlock protocol: publishing never blocks on the readers,
+* and a reader gets the latest record with a few loads and one copy of the
+* record, without any system call.
+*
+* Publication is only available where POSIX shared memory is (not on
+* Windows); Open() fails elsewhere.
+*
+* @sa
+* vtkEllipseWidget vtkEllipseStatistics vtkEllipseROISharedMemoryReader
+*/
+
+#ifndef vtkEllipseROIPublisher_h
+#define vtkEllipseROIPublisher_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkEllipseWidget;
+class vtkEllipseStatistics;
+class vtkCallbackCommand;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseROIPublisher : public vtkObject
+class vtkEllipseROIPublisher : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseROIPublisher *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseROIPublisher, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Name of the shared memory segment, "/vtkEllipseROI" by default. Used by
+	* the next Open().
+	*/
+	vtkSetStringMacro(Name);
+	vtkGetStringMacro(Name);
+	//@}
+
+	//@{
+	/**
+	* Number of records kept in the ring, 64 by default. Readers can catch up
+	* on the records they missed as long as they are at most this many behind.
+	* Used by the next Open().
+	*/
+	vtkSetClampMacro(NumberOfSlots, int, 2, 65536);
+	vtkGetMacro(NumberOfSlots, int);
+	//@}
+
+	//@{
+	/**
+	* Specify the widget whose interactions are published.
+	*/
+	virtual void SetWidget(vtkEllipseWidget *widget);
+	vtkGetObjectMacro(Widget, vtkEllipseWidget);
+	//@}
+
+	//@{
+	/**
+	* Optionally specify statistics to update on the ellipse of a world
+	* anchored representation and publish with it. Its input and slice are
+	* left to the caller.
+	*/
+	virtual void SetStatistics(vtkEllipseStatistics *statistics);
+	vtkGetObjectMacro(Statistics, vtkEllipseStatistics);
+	//@}
+
+	/**
+	* Create the shared memory segment and start publishing. Return 0 on
+	* failure. A segment already published under the same name, by another
+	* publisher or one that did not close, is marked closed, so that its
+	* readers reopen the name, and replaced; a warning is issued if it was
+	* not closed yet. Give each publisher its own Name to avoid this.
+	*/
+	int Open();
+
+	/**
+	* Mark the segment closed for the readers and remove it, unless another
+	* publisher replaced it under the same name meanwhile.
+	*/
+	void Close();
+
+	/**
+	* Return 1 between Open() and Close().
+	*/
+	int IsOpen();
+
+	/**
+	* Publish the current state of the widget outside of an interaction.
+	* Return 0 if the publisher is not open or there is no representation.
+	*/
+	int Publish();
+
+	/**
+	* Number of the last record published since Open(), 0 if none.
+	*/
+	vtkTypeUInt64 GetLastSequence();
+
+protected:
+	vtkEllipseROIPublisher();
+	~vtkEllipseROIPublisher() override;
+
+	char *Name;
+	int NumberOfSlots;
+	vtkEllipseWidget *Widget;
+	vtkEllipseStatistics *Statistics;
+
+	class vtkInternals;
+	vtkInternals *Internals;
+
+	// Write a record of the current state for an event of the record
+	int Write(unsigned int event);
+
+	// Follow the interactions of the widget
+	vtkCallbackCommand *EventCallbackCommand;
+	unsigned long WidgetTags[2];
+	static void ProcessEvents(vtkObject *caller, unsigned long event,
+		void *clientdata, void *calldata);
+
+private:
+	vtkEllipseROIPublisher(const vtkEllipseROIPublisher&) = delete;
+	void operator=(const vtkEllipseROIPublisher&) = delete;
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseROISharedMemory.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseROISharedMemoryReader
+* @brief   read the ROI records published by vtkEllipseROIPublisher
+*
+* This header defines the layout of the POSIX shared memory ring written by
+* vtkEllipseROIPublisher and a reader for it. It only depends on the C++
+* standard library and POSIX, so that analysis processes can include it
+* without linking VTK (link rt on older glibc).
+*
+* The segment starts with a vtkEllipseROIRingHeader followed by
+* NumberOfSlots vtkEllipseROISlot. Record n (counted from 1) is written in
+* slot (n - 1) % NumberOfSlots, and Head is the number of the last record
+* published. Each slot is a seqlock: its Version is odd while the publisher
+* writes the record, and is incremented again once the record is complete.
+* A reader copies the record between two reads of Version and retries when
+* they differ, so it never waits for the publisher nor blocks it.
+*
+* \code
+* vtkEllipseROISharedMemoryReader reader;
+* vtkEllipseROIRecord record;
+* if (reader.Open("/vtkEllipseROI") && reader.ReadLatest(record))
+* {
+*   // record.Center, record.Radius, record.Mean...
+* }
+* \endcode
+*
+* A publisher that is closed marks the segment Closed and unlinks it;
+* readers should then reopen it to follow the next publisher.
+*
+* @sa
+* vtkEllipseROIPublisher
+*/
+
+#ifndef vtkEllipseROISharedMemory_h
+#define vtkEllipseROISharedMemory_h
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define VTK_ELLIPSE_ROI_MAGIC 0x524f4945u
+#define VTK_ELLIPSE_ROI_VERSION 1u
+
+// One published state of the ROI
+struct vtkEllipseROIRecord
+{
+	enum { INTERACTION = 0, END_INTERACTION, EXPLICIT };
+	enum { WORLD = 0, DISPLAY };
+
+	uint64_t Sequence;  // number of the record, from 1
+	int64_t Time;       // CLOCK_MONOTONIC, in nanoseconds
+	uint32_t Event;     // INTERACTION, END_INTERACTION or EXPLICIT
+	uint32_t Coordinates; // WORLD (Center[2] is the plane) or DISPLAY
+	double Center[3];
+	double Radius[2];
+	uint32_t HasStatistics; // 1 if the statistics below are set
+	int32_t Slice;
+	double Count;
+	double Area;
+	double Mean;
+	double StandardDeviation;
+	double Minimum;
+	double Maximum;
+};
+
+struct vtkEllipseROIRingHeader
+{
+	std::atomic<uint32_t> Magic; // VTK_ELLIPSE_ROI_MAGIC once initialized
+	uint32_t Version;
+	uint32_t NumberOfSlots;
+	uint32_t RecordSize;
+	std::atomic<uint32_t> Closed; // 1 once the publisher is closed
+	uint32_t Reserved;
+	std::atomic<uint64_t> Head; // number of the last record, 0 if none
+	char Padding[32]; // keep the slots off the cache line of Head
+};
+
+struct vtkEllipseROISlot
+{
+	std::atomic<uint64_t> Version; // odd while the record is written
+	vtkEllipseROIRecord Record;
+};
+
+// The seqlock is shared between processes: its atomics must be lock free,
+// a lock being private to each process
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "The ring requires lock free 32 bit atomics");
+static_assert((sizeof(uint64_t) == sizeof(long) ? ATOMIC_LONG_LOCK_FREE : ATOMIC_LLONG_LOCK_FREE) == 2,
+	"The ring requires lock free 64 bit atomics");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+	"The ring requires address free 64 bit atomics");
+static_assert(sizeof(vtkEllipseROIRingHeader) == 64, "Unexpected ring header size");
+
+class vtkEllipseROISharedMemoryReader
+{
+public:
+	vtkEllipseROISharedMemoryReader() : Header(nullptr), Slots(nullptr), Size(0) {}
+	~vtkEllipseROISharedMemoryReader() { this->Close(); }
+
+	/**
+	* Map the segment published under name (e.g. "/vtkEllipseROI"). Return
+	* false if it does not exist or has another layout, or if the atomics
+	* of the ring are not lock free on this platform.
+	*/
+	bool Open(const char *name)
+	{
+		this->Close();
+		int fd = shm_open(name, O_RDONLY, 0);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat status;
+		void *address = MAP_FAILED;
+		if (fstat(fd, &status) == 0 &&
+			static_cast<size_t>(status.st_size) >= sizeof(vtkEllipseROIRingHeader))
+		{
+			this->Size = static_cast<size_t>(status.st_size);
+			address = mmap(nullptr, this->Size, PROT_READ, MAP_SHARED, fd, 0);
+		}
+		close(fd);
+		if (address == MAP_FAILED)
+		{
+			this->Size = 0;
+			return false;
+		}
+		this->Header = static_cast<const vtkEllipseROIRingHeader*>(address);
+		this->Slots = reinterpret_cast<const vtkEllipseROISlot*>(this->Header + 1);
+		if (!this->Header->Magic.is_lock_free() || !this->Header->Head.is_lock_free() ||
+			this->Header->Magic.load(std::memory_order_acquire) != VTK_ELLIPSE_ROI_MAGIC ||
+			this->Header->Version != VTK_ELLIPSE_ROI_VERSION ||
+			this->Header->RecordSize != sizeof(vtkEllipseROIRecord) ||
+			this->Header->NumberOfSlots == 0 ||
+			this->Size < sizeof(vtkEllipseROIRingHeader) +
+				this->Header->NumberOfSlots * sizeof(vtkEllipseROISlot))
+		{
+			this->Close();
+			return false;
+		}
+		return true;
+	}
+
+	void Close()
+	{
+		if (this->Header)
+		{
+			munmap(const_cast<vtkEllipseROIRingHeader*>(this->Header), this->Size);
+		}
+		this->Header = nullptr;
+		this->Slots = nullptr;
+		this->Size = 0;
+	}
+
+	bool IsOpen() const { return this->Header != nullptr; }
+
+	/**
+	* Return true once the publisher is closed; the segment should be
+	* reopened.
+	*/
+	bool IsClosed() const
+	{
+		return !this->Header || this->Header->Closed.load(std::memory_order_acquire) != 0;
+	}
+
+	/**
+	* Number of the last record published, 0 if none. Polling it is a single
+	* load from the shared memory.
+	*/
+	uint64_t GetHead() const
+	{
+		return this->Header ? this->Header->Head.load(std::memory_order_acquire) : 0;
+	}
+
+	uint32_t GetNumberOfSlots() const
+	{
+		return this->Header ? this->Header->NumberOfSlots : 0;
+	}
+
+	/**
+	* Copy record sequence. Return false if it is not published yet, or was
+	* already overwritten by a record NumberOfSlots later.
+	*/
+	bool Read(uint64_t sequence, vtkEllipseROIRecord &record) const
+	{
+		if (sequence == 0 || sequence > this->GetHead())
+		{
+			return false;
+		}
+		const vtkEllipseROISlot *slot =
+			this->Slots + (sequence - 1) % this->Header->NumberOfSlots;
+
+		// The publisher writes a record in well under a microsecond; only a
+		// publisher that died while writing makes all the attempts fail
+		for (int attempt = 0; attempt < 4096; attempt++)
+		{
+			uint64_t version = slot->Version.load(std::memory_order_acquire);
+			if (version & 1)
+			{
+				continue;
+			}
+			memcpy(&record, &slot->Record, sizeof(vtkEllipseROIRecord));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot->Version.load(std::memory_order_relaxed) == version)
+			{
+				return record.Sequence == sequence;
+			}
+		}
+		return false;
+	}
+
+	/**
+	* Copy the last record published. Return false if there is none.
+	*/
+	bool ReadLatest(vtkEllipseROIRecord &record) const
+	{
+		for (int attempt = 0; attempt < 16; attempt++)
+		{
+			uint64_t head = this->GetHead();
+			if (head == 0)
+			{
+				return false;
+			}
+			if (this->Read(head, record))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	const vtkEllipseROIRingHeader *Header;
+	const vtkEllipseROISlot *Slots;
+	size_t Size;
+
+	vtkEllipseROISharedMemoryReader(const vtkEllipseROISharedMemoryReader&) = delete;
+	void operator=(const vtkEllipseROISharedMemoryReader&) = delete;
+};
+
+#endif // _WIN32
+
+#endif
@@ -0,0 +1,313 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseRegionSelector.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseRegionSelector.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkCamera.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMatrix4x4.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkRenderer.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseRegionSelector);
+
+//-------------------------------------------------------------------------
+// Project world points to display and express them in the normalized frame
+// of the ellipse, where the ellipse is the unit disk.
+struct vtkEllipseRegionProjection
+{
+	double P[16];
+	double Center[2];
+	double InvRadius[2];
+
+	bool Project(double x, double y, double z, double &u, double &v) const
+	{
+		const double *P = this->P;
+		double w = P[12] * x + P[13] * y + P[14] * z + P[15];
+		if (w <= 0.0)
+		{
+			return false; // behind the camera
+		}
+		u = ((P[0] * x + P[1] * y + P[2] * z + P[3]) / w - this->Center[0]) * this->InvRadius[0];
+		v = ((P[4] * x + P[5] * y + P[6] * z + P[7]) / w - this->Center[1]) * this->InvRadius[1];
+		return true;
+	}
+};
+
+//-------------------------------------------------------------------------
+// Classify the buckets of the locator, then the points of the buckets that
+// cross the boundary of the ellipse
+template <class T>
+class vtkEllipseRegionSelectorFunctor
+{
+public:
+	const T *Points;
+	vtkStaticPointLocator *Locator;
+	double Origin[3];
+	double BucketSize[3];
+	int Divisions[3];
+	vtkEllipseRegionProjection Projection;
+
+	vtkSMPThreadLocal<std::vector<vtkIdType> > Ids;
+	vtkSMPThreadLocal<vtkSmartPointer<vtkIdList> > BucketIds;
+
+	void Initialize()
+	{
+		this->BucketIds.Local() = vtkSmartPointer<vtkIdList>::New();
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		std::vector<vtkIdType> &ids = this->Ids.Local();
+		vtkIdList *bucketIds = this->BucketIds.Local();
+		const vtkIdType sliceSize =
+			static_cast<vtkIdType>(this->Divisions[0]) * this->Divisions[1];
+
+		for (vtkIdType b = begin; b < end; b++)
+		{
+			if (this->Locator->GetNumberOfPointsInBucket(b) == 0)
+			{
+				continue;
+			}
+
+			// Project the corners of the bucket
+			int ijk[3] = {
+				static_cast<int>(b % this->Divisions[0]),
+				static_cast<int>((b / this->Divisions[0]) % this->Divisions[1]),
+				static_cast<int>(b / sliceSize) };
+			double lo[3], hi[3];
+			for (int a = 0; a < 3; a++)
+			{
+				lo[a] = this->Origin[a] + ijk[a] * this->BucketSize[a];
+				hi[a] = lo[a] + this->BucketSize[a];
+			}
+			bool behind = false;
+			bool allInside = true;
+			double uMin = VTK_DOUBLE_MAX, uMax = VTK_DOUBLE_MIN;
+			double vMin = VTK_DOUBLE_MAX, vMax = VTK_DOUBLE_MIN;
+			for (int c = 0; c < 8 && !behind; c++)
+			{
+				double u, v;
+				if (!this->Projection.Project((c & 1) ? hi[0] : lo[0],
+					(c & 2) ? hi[1] : lo[1], (c & 4) ? hi[2] : lo[2], u, v))
+				{
+					behind = true;
+					break;
+				}
+				uMin = std::min(uMin, u);
+				uMax = std::max(uMax, u);
+				vMin = std::min(vMin, v);
+				vMax = std::max(vMax, v);
+				allInside = allInside && (u * u + v * v <= 1.0);
+			}
+
+			if (!behind)
+			{
+				// The projection of the bucket is inside its screen bounding box
+				double cu = std::min(std::max(0.0, uMin), uMax);
+				double cv = std::min(std::max(0.0, vMin), vMax);
+				if (cu * cu + cv * cv > 1.0)
+				{
+					continue;
+				}
+			}
+
+			this->Locator->GetBucketIds(b, bucketIds);
+			vtkIdType numIds = bucketIds->GetNumberOfIds();
+			const vtkIdType *idPtr = bucketIds->GetPointer(0);
+			if (!behind && allInside)
+			{
+				ids.insert(ids.end(), idPtr, idPtr + numIds);
+				continue;
+			}
+			for (vtkIdType t = 0; t < numIds; t++)
+			{
+				const T *x = this->Points + 3 * idPtr[t];
+				double u, v;
+				if (this->Projection.Project(x[0], x[1], x[2], u, v) && u * u + v * v <= 1.0)
+				{
+					ids.push_back(idPtr[t]);
+				}
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseRegionSelectorExecute(const T *points, vtkStaticPointLocator *locator,
+	const vtkEllipseRegionProjection &projection, std::vector<vtkIdType> &selected)
+{
+	vtkEllipseRegionSelectorFunctor<T> functor;
+	functor.Points = points;
+	functor.Locator = locator;
+	functor.Projection = projection;
+	const double *bounds = locator->GetBounds();
+	locator->GetDivisions(functor.Divisions);
+	for (int a = 0; a < 3; a++)
+	{
+		functor.Origin[a] = bounds[2 * a];
+		functor.BucketSize[a] = (bounds[2 * a + 1] - bounds[2 * a]) / functor.Divisions[a];
+	}
+	vtkIdType numBuckets = static_cast<vtkIdType>(functor.Divisions[0]) *
+		functor.Divisions[1] * functor.Divisions[2];
+	vtkSMPTools::For(0, numBuckets, functor);
+
+	for (auto it = functor.Ids.begin(); it != functor.Ids.end(); ++it)
+	{
+		selected.insert(selected.end(), it->begin(), it->end());
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseRegionSelector::vtkEllipseRegionSelector()
+{
+	this->Input = nullptr;
+	this->Representation = nullptr;
+	this->NumberOfPointsPerBucket = 128;
+	this->Locator = vtkStaticPointLocator::New();
+
+	this->SelectedIds = vtkIdTypeArray::New();
+	this->SelectedIds->SetName("SelectedIds");
+	vtkSelectionNode *node = vtkSelectionNode::New();
+	node->SetFieldType(vtkSelectionNode::POINT);
+	node->SetContentType(vtkSelectionNode::INDICES);
+	node->SetSelectionList(this->SelectedIds);
+	this->Selection = vtkSelection::New();
+	this->Selection->AddNode(node);
+	node->Delete();
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseRegionSelector::~vtkEllipseRegionSelector()
+{
+	this->SetInputData(nullptr);
+	this->SetRepresentation(nullptr);
+	this->Locator->Delete();
+	this->SelectedIds->Delete();
+	this->Selection->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRegionSelector::SetInputData(vtkPointSet *input)
+{
+	vtkSetObjectBodyMacro(Input, vtkPointSet, input);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRegionSelector::SetRepresentation(vtkEllipseRepresentation *rep)
+{
+	vtkSetObjectBodyMacro(Representation, vtkEllipseRepresentation, rep);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRegionSelector::ComputeProjection(vtkRenderer *ren, double projection[16])
+{
+	// world to normalized device coordinates
+	vtkMatrix4x4 *m = ren->GetActiveCamera()->
+		GetCompositeProjectionTransformMatrix(ren->GetTiledAspectRatio(), -1, 1);
+
+	// then normalized device to display coordinates of the viewport
+	int *origin = ren->GetOrigin();
+	int *size = ren->GetSize();
+	for (int col = 0; col < 4; col++)
+	{
+		double w = m->GetElement(3, col);
+		projection[col] = 0.5 * size[0] * (m->GetElement(0, col) + w) + origin[0] * w;
+		projection[4 + col] = 0.5 * size[1] * (m->GetElement(1, col) + w) + origin[1] * w;
+		projection[8 + col] = m->GetElement(2, col);
+		projection[12 + col] = w;
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRegionSelector::Update()
+{
+	this->SelectedIds->Reset();
+	this->SelectedIds->Modified();
+	this->Selection->Modified();
+
+	if (!this->Input || !this->Input->GetPoints() || this->Input->GetNumberOfPoints() == 0)
+	{
+		return;
+	}
+	vtkRenderer *ren = this->Representation ? this->Representation->GetRenderer() : nullptr;
+	double p1[2], p2[2];
+	if (!ren || !this->Representation->GetDisplayCorners(p1, p2))
+	{
+		vtkErrorMacro(<< "A representation attached to a renderer is required");
+		return;
+	}
+	if (p2[0] <= p1[0] || p2[1] <= p1[1])
+	{
+		return;
+	}
+
+	vtkEllipseRegionProjection projection;
+	vtkEllipseRegionSelector::ComputeProjection(ren, projection.P);
+	projection.Center[0] = 0.5 * (p1[0] + p2[0]);
+	projection.Center[1] = 0.5 * (p1[1] + p2[1]);
+	projection.InvRadius[0] = 2.0 / (p2[0] - p1[0]);
+	projection.InvRadius[1] = 2.0 / (p2[1] - p1[1]);
+
+	// The locator is only rebuilt when the input changes
+	this->Locator->SetDataSet(this->Input);
+	this->Locator->SetNumberOfPointsPerBucket(this->NumberOfPointsPerBucket);
+	this->Locator->BuildLocator();
+
+	std::vector<vtkIdType> selected;
+	vtkDataArray *points = this->Input->GetPoints()->GetData();
+	switch (points->GetDataType())
+	{
+	case VTK_FLOAT:
+		vtkEllipseRegionSelectorExecute(static_cast<const float*>(points->GetVoidPointer(0)),
+			this->Locator, projection, selected);
+		break;
+	case VTK_DOUBLE:
+		vtkEllipseRegionSelectorExecute(static_cast<const double*>(points->GetVoidPointer(0)),
+			this->Locator, projection, selected);
+		break;
+	default:
+		vtkErrorMacro(<< "Only float and double points are supported");
+		return;
+	}
+	std::sort(selected.begin(), selected.end());
+
+	this->SelectedIds->SetNumberOfTuples(static_cast<vtkIdType>(selected.size()));
+	std::copy(selected.begin(), selected.end(), this->SelectedIds->GetPointer(0));
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRegionSelector::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Representation: " << this->Representation << "\n";
+	os << indent << "Number Of Points Per Bucket: " << this->NumberOfPointsPerBucket << "\n";
+	os << indent << "Number Of Selected Points: "
+		<< this->SelectedIds->GetNumberOfTuples() << "\n";
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseRegionSelector.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseRegionSelector
+* @brief   select the points of a dataset that project inside an ellipse
+*
+* vtkEllipseRegionSelector selects the points of a vtkPointSet (e.g., a point
+* cloud or a mesh given as vtkPolyData) that lie in the elliptic cone going
+* from the camera through the ellipse of a vtkEllipseRepresentation, i.e.,
+* the points that are drawn inside the ellipse on screen.
+*
+* The points are bucketed once with a vtkStaticPointLocator, rebuilt only
+* when the input changes. Each selection projects the corners of the buckets
+* through the active camera: buckets whose projection misses the ellipse are
+* rejected, buckets that project entirely inside it are accepted without
+* looking at their points, and only the points of the buckets crossing the
+* boundary of the ellipse are projected and tested. Buckets are processed in
+* parallel with vtkSMPTools.
+*
+* The result is available as a sorted list of point ids and as a vtkSelection
+* holding a single point index selection node.
+*
+* @sa
+* vtkEllipseWidget vtkEllipseRepresentation vtkStaticPointLocator
+*/
+
+#ifndef vtkEllipseRegionSelector_h
+#define vtkEllipseRegionSelector_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkPointSet;
+class vtkRenderer;
+class vtkEllipseRepresentation;
+class vtkStaticPointLocator;
+class vtkIdTypeArray;
+class vtkSelection;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseRegionSelector : public vtkObject
+class vtkEllipseRegionSelector : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseRegionSelector *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseRegionSelector, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the points to select from. A bare vtkPoints can be wrapped in a
+	* vtkPolyData.
+	*/
+	virtual void SetInputData(vtkPointSet *input);
+	vtkGetObjectMacro(Input, vtkPointSet);
+	//@}
+
+	//@{
+	/**
+	* Specify the representation whose ellipse defines the selection. The
+	* representation must be attached to a renderer, whose active camera
+	* defines the projection.
+	*/
+	virtual void SetRepresentation(vtkEllipseRepresentation *rep);
+	vtkGetObjectMacro(Representation, vtkEllipseRepresentation);
+	//@}
+
+	//@{
+	/**
+	* Average number of points per bucket of the point locator. Larger
+	* buckets mean fewer bucket tests but more point tests. 128 by default.
+	*/
+	vtkSetClampMacro(NumberOfPointsPerBucket, int, 1, VTK_INT_MAX);
+	vtkGetMacro(NumberOfPointsPerBucket, int);
+	//@}
+
+	/**
+	* Select the points inside the ellipse with the current camera. Unlike
+	* the other algorithms of this library the selection is always redone,
+	* since the camera is not tracked; only the locator is cached.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* Results of the last update: the sorted ids of the selected points and
+	* the equivalent vtkSelection.
+	*/
+	vtkGetObjectMacro(SelectedIds, vtkIdTypeArray);
+	vtkGetObjectMacro(Selection, vtkSelection);
+	//@}
+
+protected:
+	vtkEllipseRegionSelector();
+	~vtkEllipseRegionSelector() override;
+
+	vtkPointSet *Input;
+	vtkEllipseRepresentation *Representation;
+	int NumberOfPointsPerBucket;
+
+	vtkStaticPointLocator *Locator;
+	vtkIdTypeArray *SelectedIds;
+	vtkSelection *Selection;
+
+	// Compute the world to display projection of the renderer as a 4x4 row
+	// major matrix; display x and y are rows 0 and 1 divided by row 3.
+	static void ComputeProjection(vtkRenderer *ren, double projection[16]);
+
+private:
+	vtkEllipseRegionSelector(const vtkEllipseRegionSelector&) = delete;
+	void operator=(const vtkEllipseRegionSelector&) = delete;
+};
+
+#endif
@@ -9,23 +9,58 @@ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 PURPOSE.  See the above copyright notice for more information.
 =========================================================================*/
 #include "vtkEllipseRepresentation.h"
+#include "vtkEllipseTrace.h"
+#include "vtkEllipseModel.h"
 #include "vtkRenderer.h"
+#include "vtkCamera.h"
 #include "vtkPoints.h"
 #include "vtkCellArray.h"
+#include "vtkDataArray.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataMapper2D.h"
 #include "vtkActor2D.h"
 #include "vtkProperty2D.h"
 #include "vtkTransform.h"
 #include "vtkTransformPolyDataFilter.h"
+#include "vtkAppendPolyData.h"
 #include "vtkWindow.h"
+#include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <map>
+#include <mutex>
 
 vtkStandardNewMacro(vtkEllipseRepresentation);
 
+//-------------------------------------------------------------------------
+// Conversions between display and normalized viewport coordinates, the two
+// systems the widget and the representation exchange event positions in.
+static void DisplayToNormalizedViewport(vtkViewport *v, double &x, double &y)
+{
+	v->DisplayToNormalizedDisplay(x, y);
+	v->NormalizedDisplayToViewport(x, y);
+	v->ViewportToNormalizedViewport(x, y);
+}
+
+static void NormalizedViewportToDisplay(vtkViewport *v, double &x, double &y)
+{
+	v->NormalizedViewportToViewport(x, y);
+	v->ViewportToNormalizedDisplay(x, y);
+	v->NormalizedDisplayToDisplay(x, y);
+}
+
+template <class T>
+static void vtkEllipseRepresentationDelete(T *&object)
+{
+	if (object)
+	{
+		object->Delete();
+		object = nullptr;
+	}
+}
 
 //-------------------------------------------------------------------------
 vtkEllipseRepresentation::vtkEllipseRepresentation()
@@ -48,43 +83,66 @@ vtkEllipseRepresentation::vtkEllipseRepresentation()
 	this->Position2Coordinate->SetValue(0.1, 0.1); //may be updated by the subclass
 	this->Position2Coordinate->SetReferenceCoordinate(this->PositionCoordinate);
 
-	// Create the geometry in canonical coordinates
-	this->EWPoints = vtkPoints::New();
-	this->EWPoints->SetDataTypeToDouble();
-	this->EWPoints->SetNumberOfPoints(50);
-	for (unsigned int i = 0; i < this->Resolution; i++)
+	// World anchoring is off by default; the affine cache is empty
+	this->AnchorMode = ANCHOR_VIEWPORT;
+	for (int i = 0; i < 6; i++)
 	{
-		const double angle = 2.0 * vtkMath::Pi() * static_cast<double>(i) /
-			static_cast<double>(this->Resolution);
-		this->EWPoints->SetPoint(i, 0.5*cos(angle) + 0.5, 0.5*sin(angle) + 0.5, 0);
+		this->WorldToDisplay[i] = this->DisplayToWorld[i] = 0.0;
 	}
+	this->DisplayToViewportOffset[0] = this->DisplayToViewportOffset[1] = 0.0;
+	this->CachedPlaneZ = 0.0;
+	this->Placed = 1;
+	this->CachedCameraMTime = 0;
+	this->CachedRendererMTime = 0;
+	this->CachedWindowMTime = 0;
+	this->CachedViewport = nullptr;
+	this->Model = nullptr;
 
-	vtkCellArray *outline = vtkCellArray::New();
-	outline->InsertNextCell(this->Resolution + 1);
-	for (int i = 0; i < this->EWPoints->GetNumberOfPoints(); i++)
-	{
-		outline->InsertCellPoint(i);
-	}
-	outline->InsertCellPoint(0);
+	// The geometry in canonical coordinates is shared by all representations
+	// of the same resolution
+	this->EWPolyData = vtkEllipseRepresentation::GetCanonicalOutline(this->Resolution);
+	this->EWPolyData->Register(this);
+	this->EWPoints = this->EWPolyData->GetPoints();
+	this->EWPoints->Register(this);
 
-	this->EWPolyData = vtkPolyData::New();
-	this->EWPolyData->SetPoints(this->EWPoints);
-	this->EWPolyData->SetLines(outline);
-	outline->Delete();
+	// Level of detail and culling
+	this->LevelOfDetail = 1;
+	this->ViewportCulling = 1;
+	this->PointLODSize = 3;
+	this->ReducedLODSize = 40;
+	this->ReducedResolution = 12;
+	this->CurrentResolution = this->Resolution;
 
-	this->EWTransform = vtkTransform::New();
-	this->EWTransformFilter = vtkTransformPolyDataFilter::New();
-	this->EWTransformFilter->SetTransform(this->EWTransform);
-	this->EWTransformFilter->SetInputData(this->EWPolyData);
+	// The rendering pipeline is created on first render, see CreatePipeline()
+	this->EWTransform = nullptr;
+	this->EWTransformFilter = nullptr;
+	this->EWMapper = nullptr;
+	this->EWActor = nullptr;
+	this->EllipseProperty = vtkProperty2D::New();
+	this->PipelineReleaseDelay = 0;
+	this->CulledFrames = 0;
 
-	this->EWMapper = vtkPolyDataMapper2D::New();
-	this->EWMapper->SetInputConnection(
-		this->EWTransformFilter->GetOutputPort());
-	this->EWActor = vtkActor2D::New();
-	this->EWActor->SetMapper(this->EWMapper);
+	// Background ring, off by default
+	this->Annulus = 0;
+	this->AnnulusInnerScale = 1.0;
+	this->AnnulusOuterScale = 1.5;
+	this->RingInnerTransform = nullptr;
+	this->RingOuterTransform = nullptr;
+	this->RingInnerTransformFilter = nullptr;
+	this->RingOuterTransformFilter = nullptr;
+	this->RingAppend = nullptr;
+	this->RingMapper = nullptr;
+	this->RingActor = nullptr;
+	this->RingProperty = vtkProperty2D::New();
+	this->RingProperty->SetColor(0.5, 0.5, 0.5);
 
-	this->EllipseProperty = vtkProperty2D::New();
-	this->EWActor->SetProperty(this->EllipseProperty);
+	// Interior fill, off by default
+	this->Fill = 0;
+	this->FillTransformFilter = nullptr;
+	this->FillMapper = nullptr;
+	this->FillActor = nullptr;
+	this->FillProperty = vtkProperty2D::New();
+	this->FillProperty->SetOpacity(0.3);
 
 	this->MinimumSize[0] = 1;
 	this->MinimumSize[1] = 1;
@@ -99,14 +157,145 @@ vtkEllipseRepresentation::~vtkEllipseRepresentation()
 {
 	this->PositionCoordinate->Delete();
 	this->Position2Coordinate->Delete();
+	if (this->Model)
+	{
+		this->Model->UnRegister(this);
+	}
 
-	this->EWPoints->Delete();
-	this->EWTransform->Delete();
-	this->EWTransformFilter->Delete();
-	this->EWPolyData->Delete();
-	this->EWMapper->Delete();
-	this->EWActor->Delete();
+	this->ReleasePipeline(nullptr);
+	this->EWPoints->UnRegister(this);
+	this->EWPolyData->UnRegister(this);
 	this->EllipseProperty->Delete();
+	this->RingProperty->Delete();
+	this->FillProperty->Delete();
+}
+
+//-------------------------------------------------------------------------
+// Create the transforms, filters, mappers and actors drawing the ellipse,
+// and those of the background ring when it is shown
+void vtkEllipseRepresentation::CreatePipeline()
+{
+	if (!this->EWActor)
+	{
+		this->CurrentResolution = this->Resolution;
+		this->EWTransform = vtkTransform::New();
+		this->EWTransformFilter = vtkTransformPolyDataFilter::New();
+		this->EWTransformFilter->SetTransform(this->EWTransform);
+		this->EWTransformFilter->SetInputData(this->EWPolyData);
+
+		this->EWMapper = vtkPolyDataMapper2D::New();
+		this->EWMapper->SetInputConnection(
+			this->EWTransformFilter->GetOutputPort());
+		this->EWActor = vtkActor2D::New();
+		this->EWActor->SetMapper(this->EWMapper);
+		this->EWActor->SetProperty(this->EllipseProperty);
+		this->PipelineTime.Modified();
+	}
+
+	if (this->Annulus && !this->RingActor)
+	{
+		vtkPolyData *outline = this->CurrentResolution == this->Resolution ? this->EWPolyData :
+			vtkEllipseRepresentation::GetCanonicalOutline(this->CurrentResolution);
+		this->RingInnerTransform = vtkTransform::New();
+		this->RingOuterTransform = vtkTransform::New();
+		this->RingInnerTransformFilter = vtkTransformPolyDataFilter::New();
+		this->RingInnerTransformFilter->SetTransform(this->RingInnerTransform);
+		this->RingInnerTransformFilter->SetInputData(outline);
+		this->RingOuterTransformFilter = vtkTransformPolyDataFilter::New();
+		this->RingOuterTransformFilter->SetTransform(this->RingOuterTransform);
+		this->RingOuterTransformFilter->SetInputData(outline);
+		this->RingAppend = vtkAppendPolyData::New();
+		this->RingAppend->AddInputConnection(this->RingInnerTransformFilter->GetOutputPort());
+		this->RingAppend->AddInputConnection(this->RingOuterTransformFilter->GetOutputPort());
+		this->RingMapper = vtkPolyDataMapper2D::New();
+		this->RingMapper->SetInputConnection(this->RingAppend->GetOutputPort());
+		this->RingActor = vtkActor2D::New();
+		this->RingActor->SetMapper(this->RingMapper);
+		this->RingActor->SetProperty(this->RingProperty);
+		this->PipelineTime.Modified();
+	}
+
+	// The fill shares the transform of the outline; the transform filter
+	// passes the shared strip through and only computes new points
+	if (this->Fill && !this->FillActor)
+	{
+		this->FillTransformFilter = vtkTransformPolyDataFilter::New();
+		this->FillTransformFilter->SetTransform(this->EWTransform);
+		this->FillTransformFilter->SetInputData(
+			vtkEllipseRepresentation::GetCanonicalFill(this->CurrentResolution));
+		this->FillMapper = vtkPolyDataMapper2D::New();
+		this->FillMapper->SetInputConnection(this->FillTransformFilter->GetOutputPort());
+		this->FillActor = vtkActor2D::New();
+		this->FillActor->SetMapper(this->FillMapper);
+		this->FillActor->SetProperty(this->FillProperty);
+		this->PipelineTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+// Delete the rendering pipeline, releasing the graphics resources of the
+// actors in the given window first. Only the state of the ellipse remains.
+void vtkEllipseRepresentation::ReleasePipeline(vtkWindow *w)
+{
+	if (w)
+	{
+		this->ReleaseGraphicsResources(w);
+	}
+
+	vtkEllipseRepresentationDelete(this->EWActor);
+	vtkEllipseRepresentationDelete(this->EWMapper);
+	vtkEllipseRepresentationDelete(this->EWTransformFilter);
+	vtkEllipseRepresentationDelete(this->EWTransform);
+	vtkEllipseRepresentationDelete(this->RingActor);
+	vtkEllipseRepresentationDelete(this->RingMapper);
+	vtkEllipseRepresentationDelete(this->RingAppend);
+	vtkEllipseRepresentationDelete(this->RingInnerTransformFilter);
+	vtkEllipseRepresentationDelete(this->RingOuterTransformFilter);
+	vtkEllipseRepresentationDelete(this->RingInnerTransform);
+	vtkEllipseRepresentationDelete(this->RingOuterTransform);
+	vtkEllipseRepresentationDelete(this->FillActor);
+	vtkEllipseRepresentationDelete(this->FillMapper);
+	vtkEllipseRepresentationDelete(this->FillTransformFilter);
+	this->CulledFrames = 0;
+}
+
+//-------------------------------------------------------------------------
+vtkIdType vtkEllipseRepresentation::GetMemoryFootprint()
+{
+	// The state of the ellipse
+	vtkIdType size = static_cast<vtkIdType>(sizeof(*this) +
+		2 * sizeof(vtkCoordinate) + 2 * sizeof(vtkProperty2D));
+
+	// The rendering pipeline and the outlines it holds. The canonical outlines
+	// are shared by all representations and not counted.
+	if (this->EWActor)
+	{
+		size += static_cast<vtkIdType>(sizeof(vtkTransform) +
+			sizeof(vtkTransformPolyDataFilter) + sizeof(vtkPolyDataMapper2D) +
+			sizeof(vtkActor2D));
+		size += 1024 * static_cast<vtkIdType>(
+			this->EWTransformFilter->GetOutput()->GetActualMemorySize());
+	}
+	if (this->RingActor)
+	{
+		size += static_cast<vtkIdType>(2 * sizeof(vtkTransform) +
+			2 * sizeof(vtkTransformPolyDataFilter) + sizeof(vtkAppendPolyData) +
+			sizeof(vtkPolyDataMapper2D) + sizeof(vtkActor2D));
+		size += 1024 * static_cast<vtkIdType>(
+			this->RingInnerTransformFilter->GetOutput()->GetActualMemorySize() +
+			this->RingOuterTransformFilter->GetOutput()->GetActualMemorySize() +
+			this->RingAppend->GetOutput()->GetActualMemorySize());
+	}
+	if (this->FillActor)
+	{
+		// Only the points of the fill are owned, its strip is shared
+		size += static_cast<vtkIdType>(sizeof(vtkTransformPolyDataFilter) +
+			sizeof(vtkPolyDataMapper2D) + sizeof(vtkActor2D));
+		size += 1024 * static_cast<vtkIdType>(
+			this->FillTransformFilter->GetOutput()->GetPoints() ?
+			this->FillTransformFilter->GetOutput()->GetPoints()->GetData()->GetActualMemorySize() : 0);
+	}
+	return size;
 }
 
 //----------------------------------------------------------------------------
@@ -116,6 +305,12 @@ vtkMTimeType vtkEllipseRepresentation::GetMTime()
 	mTime = std::max(mTime, this->PositionCoordinate->GetMTime());
 	mTime = std::max(mTime, this->Position2Coordinate->GetMTime());
 	mTime = std::max(mTime, this->EllipseProperty->GetMTime());
+	mTime = std::max(mTime, this->RingProperty->GetMTime());
+	mTime = std::max(mTime, this->FillProperty->GetMTime());
+	if (this->Model)
+	{
+		mTime = std::max(mTime, this->Model->GetMTime());
+	}
 	return mTime;
 }
 
@@ -129,6 +324,8 @@ void vtkEllipseRepresentation::StartWidgetInteraction(double eventPos[2])
 //-------------------------------------------------------------------------
 void vtkEllipseRepresentation::WidgetInteraction(double eventPos[2])
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::WidgetInteraction");
+
 	double XF = eventPos[0];
 	double YF = eventPos[1];
 
@@ -137,9 +334,32 @@ void vtkEllipseRepresentation::WidgetInteraction(double eventPos[2])
 	this->Renderer->NormalizedDisplayToViewport(XF, YF);
 	this->Renderer->ViewportToNormalizedViewport(XF, YF);
 
-	// there are four parameters that can be adjusted
-	double *fpos1 = this->PositionCoordinate->GetValue();
-	double *fpos2 = this->Position2Coordinate->GetValue();
+	// there are four parameters that can be adjusted. In world anchored mode
+	// the on-screen rectangle is adjusted and mapped back to world afterwards.
+	double fpos1[2], fpos2[2];
+	if (this->AnchorMode == ANCHOR_WORLD)
+	{
+		double d1[2], d2[2];
+		if (!this->GetDisplayCorners(d1, d2))
+		{
+			return;
+		}
+		DisplayToNormalizedViewport(this->Renderer, d1[0], d1[1]);
+		DisplayToNormalizedViewport(this->Renderer, d2[0], d2[1]);
+		fpos1[0] = d1[0];
+		fpos1[1] = d1[1];
+		fpos2[0] = d2[0] - d1[0];
+		fpos2[1] = d2[1] - d1[1];
+	}
+	else
+	{
+		double *value1 = this->PositionCoordinate->GetValue();
+		double *value2 = this->Position2Coordinate->GetValue();
+		fpos1[0] = value1[0];
+		fpos1[1] = value1[1];
+		fpos2[0] = value2[0];
+		fpos2[1] = value2[1];
+	}
 	double par1[2];
 	double par2[2];
 	par1[0] = fpos1[0];
@@ -209,8 +429,17 @@ void vtkEllipseRepresentation::WidgetInteraction(double eventPos[2])
 	// Modify the representation
 	if (par2[0] > par1[0] && par2[1] > par1[1])
 	{
-		this->PositionCoordinate->SetValue(par1[0], par1[1]);
-		this->Position2Coordinate->SetValue(par2[0] - par1[0], par2[1] - par1[1]);
+		if (this->AnchorMode == ANCHOR_WORLD)
+		{
+			NormalizedViewportToDisplay(this->Renderer, par1[0], par1[1]);
+			NormalizedViewportToDisplay(this->Renderer, par2[0], par2[1]);
+			this->SetDisplayCorners(par1, par2);
+		}
+		else
+		{
+			this->PositionCoordinate->SetValue(par1[0], par1[1]);
+			this->Position2Coordinate->SetValue(par2[0] - par1[0], par2[1] - par1[1]);
+		}
 		this->StartEventPosition[0] = XF;
 		this->StartEventPosition[1] = YF;
 	}
@@ -223,34 +452,129 @@ void vtkEllipseRepresentation::WidgetInteraction(double eventPos[2])
 //-------------------------------------------------------------------------
 void vtkEllipseRepresentation::NegotiateLayout()
 {
-	double size[2];
-	this->GetSize(size);
+}
+
+//-------------------------------------------------------------------------
+vtkPolyData *vtkEllipseRepresentation::GetCanonicalOutline(int resolution)
+{
+	static std::map<int, vtkSmartPointer<vtkPolyData> > outlines;
+	static std::mutex outlinesMutex;
 
-	// Update the initial ellipse geometry
-	for (unsigned int i = 0; i < this->Resolution; i++)
+	resolution = std::max(resolution, 3);
+	std::lock_guard<std::mutex> lock(outlinesMutex);
+	vtkSmartPointer<vtkPolyData> &outline = outlines[resolution];
+	if (!outline)
 	{
-		const double angle = 2.0 * vtkMath::Pi() * static_cast<double>(i) /
-			static_cast<double>(this->Resolution);
-		this->EWPoints->SetPoint(i, 0.5*cos(angle) + 0.5, 0.5*sin(angle) + 0.5, 0);
+		// Unit circle inscribed in [0,1]x[0,1]
+		vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+		points->SetDataTypeToDouble();
+		points->SetNumberOfPoints(resolution);
+		for (int i = 0; i < resolution; i++)
+		{
+			const double angle = 2.0 * vtkMath::Pi() * static_cast<double>(i) /
+				static_cast<double>(resolution);
+			points->SetPoint(i, 0.5*cos(angle) + 0.5, 0.5*sin(angle) + 0.5, 0);
+		}
+
+		vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+		lines->InsertNextCell(resolution + 1);
+		for (int i = 0; i < resolution; i++)
+		{
+			lines->InsertCellPoint(i);
+		}
+		lines->InsertCellPoint(0);
+
+		outline = vtkSmartPointer<vtkPolyData>::New();
+		outline->SetPoints(points);
+		outline->SetLines(lines);
 	}
+	return outline;
+}
+
+//-------------------------------------------------------------------------
+vtkPolyData *vtkEllipseRepresentation::GetCanonicalFill(int resolution)
+{
+	static std::map<int, vtkSmartPointer<vtkPolyData> > fills;
+	static std::mutex fillsMutex;
+
+	resolution = std::max(resolution, 3);
+	vtkPolyData *outline = vtkEllipseRepresentation::GetCanonicalOutline(resolution);
+	std::lock_guard<std::mutex> lock(fillsMutex);
+	vtkSmartPointer<vtkPolyData> &fill = fills[resolution];
+	if (!fill)
+	{
+		// One strip zigzagging across the convex outline: 0, 1, n-1, 2, n-2...
+		vtkSmartPointer<vtkCellArray> strips = vtkSmartPointer<vtkCellArray>::New();
+		strips->InsertNextCell(resolution);
+		strips->InsertCellPoint(0);
+		for (int lo = 1, hi = resolution - 1; lo <= hi; lo++, hi--)
+		{
+			strips->InsertCellPoint(lo);
+			if (lo < hi)
+			{
+				strips->InsertCellPoint(hi);
+			}
+		}
+
+		fill = vtkSmartPointer<vtkPolyData>::New();
+		fill->SetPoints(outline->GetPoints());
+		fill->SetStrips(strips);
+	}
+	return fill;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseRepresentation::IsInViewport()
+{
+	if (!this->ViewportCulling)
+	{
+		return 1;
+	}
+
+	// A world anchored ellipse whose plane is seen edge on is not drawn
+	double p1[2], p2[2];
+	if (!this->GetDisplayCorners(p1, p2))
+	{
+		return this->AnchorMode != ANCHOR_WORLD;
+	}
+
+	// Leave room for the line width and the picking tolerance, and for the
+	// background ring around the ellipse
+	int *origin = this->Renderer->GetOrigin();
+	int *size = this->Renderer->GetSize();
+	double margin = this->Tolerance + this->EllipseProperty->GetLineWidth();
+	if (this->Annulus)
+	{
+		double scale = 0.5 * (std::max(this->AnnulusOuterScale, 1.0) - 1.0);
+		margin += scale * std::max(p2[0] - p1[0], p2[1] - p1[1]) +
+			this->RingProperty->GetLineWidth();
+	}
+	return !(p2[0] < origin[0] - margin ||
+		p2[1] < origin[1] - margin ||
+		p1[0] > origin[0] + size[0] + margin ||
+		p1[1] > origin[1] + size[1] + margin);
 }
 
 
 //-------------------------------------------------------------------------
 int vtkEllipseRepresentation::ComputeInteractionState(int X, int Y, int vtkNotUsed(modify))
 {
-	int *pos1 = this->PositionCoordinate->
-		GetComputedDisplayValue(this->Renderer);
-	int *pos2 = this->Position2Coordinate->
-		GetComputedDisplayValue(this->Renderer);
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::ComputeInteractionState");
+
+	double pos1[2], pos2[2];
+	if (!this->GetDisplayCorners(pos1, pos2))
+	{
+		this->InteractionState = vtkEllipseRepresentation::Outside;
+		return this->InteractionState;
+	}
 
 	// check for poximinity to control points
 	// Figure out where we are in the widget. Exclude inside and outside case first.
 	double center[2];
 	center[0] = (pos1[0] + pos2[0]) / 2.0;
 	center[1] = (pos1[1] + pos2[1]) / 2.0;
-	double a = abs(pos2[0] - pos1[0]) / 2.0;
-	double b = abs(pos2[1] - pos1[1]) / 2.0;
+	double a = fabs(pos2[0] - pos1[0]) / 2.0;
+	double b = fabs(pos2[1] - pos1[1]) / 2.0;
 
 	auto ellipse = [](int x, int y, double *center, double a, double b, double tolerence)->_InteractionState {
 		// ellipse equation: [(x-x0)/a]^2 + [(y-y0)/b]^2 = 1, where a and b are associated to major and minor axis length
@@ -303,8 +627,24 @@ int vtkEllipseRepresentation::ComputeInteractionState(int X, int Y, int vtkNotUs
 //-------------------------------------------------------------------------
 void vtkEllipseRepresentation::BuildRepresentation()
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::BuildRepresentation");
+
+	// In world anchored mode a camera change only refreshes the cached affine
+	if (this->AnchorMode == ANCHOR_WORLD)
+	{
+		this->UpdateWorldToDisplay();
+	}
+
+	// Nothing to build until the ellipse is first rendered
+	if (!this->EWActor)
+	{
+		return;
+	}
+
 	if (this->Renderer &&
 		(this->GetMTime() > this->BuildTime ||
+		this->PipelineTime > this->BuildTime ||
+		(this->AnchorMode == ANCHOR_WORLD && this->WorldToDisplayTime > this->BuildTime) ||
 		(this->Renderer->GetVTKWindow() &&
 			this->Renderer->GetVTKWindow()->GetMTime() > this->BuildTime)))
 	{
@@ -316,10 +656,30 @@ void vtkEllipseRepresentation::BuildRepresentation()
 		}
 
 		// Set things up
-		int *pos1 = this->PositionCoordinate->
-			GetComputedViewportValue(this->Renderer);
-		int *pos2 = this->Position2Coordinate->
-			GetComputedViewportValue(this->Renderer);
+		double pos1[2], pos2[2];
+		if (this->AnchorMode == ANCHOR_WORLD)
+		{
+			if (!this->GetDisplayCorners(pos1, pos2))
+			{
+				this->Placed = 0;
+				return;
+			}
+			pos1[0] += this->DisplayToViewportOffset[0];
+			pos1[1] += this->DisplayToViewportOffset[1];
+			pos2[0] += this->DisplayToViewportOffset[0];
+			pos2[1] += this->DisplayToViewportOffset[1];
+		}
+		else
+		{
+			int *vpos1 = this->PositionCoordinate->
+				GetComputedViewportValue(this->Renderer);
+			pos1[0] = vpos1[0];
+			pos1[1] = vpos1[1];
+			int *vpos2 = this->Position2Coordinate->
+				GetComputedViewportValue(this->Renderer);
+			pos2[0] = vpos2[0];
+			pos2[1] = vpos2[1];
+		}
 
 		// If the widget's aspect ratio is to be preserved (ProportionalResizeOn),
 		// then (pos1,pos2) are a bounding rectangle.
@@ -339,53 +699,426 @@ void vtkEllipseRepresentation::BuildRepresentation()
 		this->EWTransform->Translate(tx, ty, 0.0);
 		this->EWTransform->Scale(sx, sy, 1);
 
+		// The ring outlines are scaled about the center of the ellipse
+		double cx = 0.5 * (pos1[0] + pos2[0]);
+		double cy = 0.5 * (pos1[1] + pos2[1]);
+		if (this->RingActor)
+		{
+			this->RingInnerTransform->Identity();
+			this->RingInnerTransform->Translate(cx, cy, 0.0);
+			this->RingInnerTransform->Scale(
+				this->AnnulusInnerScale * sx, this->AnnulusInnerScale * sy, 1);
+			this->RingInnerTransform->Translate(-0.5 * size[0], -0.5 * size[1], 0.0);
+			this->RingOuterTransform->Identity();
+			this->RingOuterTransform->Translate(cx, cy, 0.0);
+			this->RingOuterTransform->Scale(
+				this->AnnulusOuterScale * sx, this->AnnulusOuterScale * sy, 1);
+			this->RingOuterTransform->Translate(-0.5 * size[0], -0.5 * size[1], 0.0);
+		}
+
+		// Pick the tessellation matching the on-screen size. Small ellipses
+		// collapse to a quad, mid-size ones use the reduced resolution.
+		int resolution = this->Resolution;
+		if (this->LevelOfDetail)
+		{
+			double extent = std::max(fabs(pos2[0] - pos1[0]), fabs(pos2[1] - pos1[1]));
+			if (extent < this->PointLODSize)
+			{
+				resolution = 4;
+			}
+			else if (extent < this->ReducedLODSize)
+			{
+				resolution = std::min(this->ReducedResolution, this->Resolution);
+			}
+		}
+		if (resolution != this->CurrentResolution)
+		{
+			this->CurrentResolution = resolution;
+			vtkPolyData *outline = resolution == this->Resolution ? this->EWPolyData :
+				vtkEllipseRepresentation::GetCanonicalOutline(resolution);
+			this->EWTransformFilter->SetInputData(outline);
+			if (this->RingActor)
+			{
+				this->RingInnerTransformFilter->SetInputData(outline);
+				this->RingOuterTransformFilter->SetInputData(outline);
+			}
+			if (this->FillActor)
+			{
+				this->FillTransformFilter->SetInputData(
+					vtkEllipseRepresentation::GetCanonicalFill(resolution));
+			}
+		}
+
+		this->Placed = 1;
 		this->BuildTime.Modified();
 	}
 }
 
+//-------------------------------------------------------------------------
+void vtkEllipseRepresentation::SetAnchorMode(int mode)
+{
+	mode = (mode == ANCHOR_WORLD ? ANCHOR_WORLD : ANCHOR_VIEWPORT);
+	if (mode == this->AnchorMode)
+	{
+		return;
+	}
+	if (this->Model && mode != ANCHOR_WORLD)
+	{
+		vtkWarningMacro(<< "A representation sharing a model must be world anchored");
+		return;
+	}
+
+	// Remember where the ellipse is on screen so that switching is seamless
+	double p1[2], p2[2];
+	int haveCorners = this->GetDisplayCorners(p1, p2);
+
+	this->AnchorMode = mode;
+	if (mode == ANCHOR_WORLD)
+	{
+		this->PositionCoordinate->SetCoordinateSystemToWorld();
+		this->Position2Coordinate->SetCoordinateSystemToWorld();
+		this->Position2Coordinate->SetReferenceCoordinate(nullptr);
+	}
+	else
+	{
+		this->PositionCoordinate->SetCoordinateSystemToNormalizedViewport();
+		this->Position2Coordinate->SetCoordinateSystemToNormalizedViewport();
+		this->Position2Coordinate->SetReferenceCoordinate(this->PositionCoordinate);
+	}
+	this->CachedCameraMTime = 0;
+
+	if (haveCorners)
+	{
+		this->SetDisplayCorners(p1, p2);
+	}
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRepresentation::SetModel(vtkEllipseModel *model)
+{
+	if (model == this->Model)
+	{
+		return;
+	}
+	// Switch to world anchoring before attaching, so that the geometry of
+	// the model is not overwritten by this representation
+	if (model)
+	{
+		this->SetAnchorModeToWorld();
+	}
+	if (this->Model)
+	{
+		this->Model->UnRegister(this);
+	}
+	this->Model = model;
+	if (this->Model)
+	{
+		this->Model->Register(this);
+	}
+	this->CachedCameraMTime = 0;
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRepresentation::GetWorldCorners(double w1[3], double w2[3])
+{
+	if (this->Model)
+	{
+		this->Model->GetPoint1(w1);
+		this->Model->GetPoint2(w2);
+		return;
+	}
+	this->PositionCoordinate->GetValue(w1);
+	this->Position2Coordinate->GetValue(w2);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRepresentation::SetWorldCorners(const double w1[3], const double w2[3])
+{
+	if (this->Model)
+	{
+		this->Model->SetCorners(w1, w2);
+		return;
+	}
+	this->PositionCoordinate->SetValue(w1[0], w1[1], w1[2]);
+	this->Position2Coordinate->SetValue(w2[0], w2[1], w2[2]);
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseRepresentation::UpdateWorldToDisplay()
+{
+	if (!this->Renderer || !this->Renderer->GetVTKWindow())
+	{
+		return 0;
+	}
+	vtkCamera *camera = this->Renderer->GetActiveCamera();
+	vtkWindow *window = this->Renderer->GetVTKWindow();
+	double w1[3], w2[3];
+	this->GetWorldCorners(w1, w2);
+	double z = w1[2];
+
+	if (this->CachedViewport == this->Renderer &&
+		this->CachedCameraMTime == camera->GetMTime() &&
+		this->CachedRendererMTime == this->Renderer->GetMTime() &&
+		this->CachedWindowMTime == window->GetMTime() &&
+		this->CachedPlaneZ == z)
+	{
+		return 1;
+	}
+
+	// Project three points of the plane z around the focal point. The mapping
+	// is affine for parallel projections, which is what image viewers use.
+	double *focal = camera->GetFocalPoint();
+	double scale = camera->GetParallelProjection() ?
+		camera->GetParallelScale() : camera->GetDistance();
+	scale = (scale > 0.0 ? scale : 1.0);
+	double world[3][2] = {
+		{ focal[0], focal[1] },
+		{ focal[0] + scale, focal[1] },
+		{ focal[0], focal[1] + scale } };
+	double display[3][2];
+	for (int i = 0; i < 3; i++)
+	{
+		this->Renderer->SetWorldPoint(world[i][0], world[i][1], z, 1.0);
+		this->Renderer->WorldToDisplay();
+		double *d = this->Renderer->GetDisplayPoint();
+		display[i][0] = d[0];
+		display[i][1] = d[1];
+	}
+
+	double a00 = (display[1][0] - display[0][0]) / scale;
+	double a10 = (display[1][1] - display[0][1]) / scale;
+	double a01 = (display[2][0] - display[0][0]) / scale;
+	double a11 = (display[2][1] - display[0][1]) / scale;
+	// The plane is seen edge on, or nearly so, when the projections of its
+	// axes are parallel
+	double det = a00 * a11 - a01 * a10;
+	double norm = std::max(a00 * a00 + a10 * a10, a01 * a01 + a11 * a11);
+	if (!(fabs(det) > 1e-9 * norm))
+	{
+		return 0;
+	}
+	double *A = this->WorldToDisplay;
+	A[0] = a00; A[1] = a01; A[2] = display[0][0] - a00 * world[0][0] - a01 * world[0][1];
+	A[3] = a10; A[4] = a11; A[5] = display[0][1] - a10 * world[0][0] - a11 * world[0][1];
+
+	double *B = this->DisplayToWorld;
+	B[0] = a11 / det; B[1] = -a01 / det;
+	B[3] = -a10 / det; B[4] = a00 / det;
+	B[2] = -(B[0] * A[2] + B[1] * A[5]);
+	B[5] = -(B[3] * A[2] + B[4] * A[5]);
+
+	// Offset from display to viewport pixels of this renderer
+	double ox = 0.0, oy = 0.0;
+	this->Renderer->DisplayToNormalizedDisplay(ox, oy);
+	this->Renderer->NormalizedDisplayToViewport(ox, oy);
+	this->DisplayToViewportOffset[0] = ox;
+	this->DisplayToViewportOffset[1] = oy;
+
+	this->CachedViewport = this->Renderer;
+	this->CachedCameraMTime = camera->GetMTime();
+	this->CachedRendererMTime = this->Renderer->GetMTime();
+	this->CachedWindowMTime = window->GetMTime();
+	this->CachedPlaneZ = z;
+	this->WorldToDisplayTime.Modified();
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseRepresentation::GetDisplayCorners(double p1[2], double p2[2])
+{
+	if (!this->Renderer || !this->Renderer->GetVTKWindow())
+	{
+		return 0;
+	}
+
+	if (this->AnchorMode == ANCHOR_WORLD)
+	{
+		if (!this->UpdateWorldToDisplay())
+		{
+			return 0;
+		}
+		const double *A = this->WorldToDisplay;
+		double w1[3], w2[3];
+		this->GetWorldCorners(w1, w2);
+		double x1 = A[0] * w1[0] + A[1] * w1[1] + A[2];
+		double y1 = A[3] * w1[0] + A[4] * w1[1] + A[5];
+		double x2 = A[0] * w2[0] + A[1] * w2[1] + A[2];
+		double y2 = A[3] * w2[0] + A[4] * w2[1] + A[5];
+
+		// The camera may flip the world axes on screen
+		p1[0] = std::min(x1, x2);
+		p1[1] = std::min(y1, y2);
+		p2[0] = std::max(x1, x2);
+		p2[1] = std::max(y1, y2);
+	}
+	else
+	{
+		int *pos1 = this->PositionCoordinate->
+			GetComputedDisplayValue(this->Renderer);
+		p1[0] = pos1[0];
+		p1[1] = pos1[1];
+		int *pos2 = this->Position2Coordinate->
+			GetComputedDisplayValue(this->Renderer);
+		p2[0] = pos2[0];
+		p2[1] = pos2[1];
+	}
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseRepresentation::SetDisplayCorners(const double p1[2], const double p2[2])
+{
+	if (!this->Renderer || !this->Renderer->GetVTKWindow())
+	{
+		return;
+	}
+
+	if (this->AnchorMode == ANCHOR_WORLD)
+	{
+		if (!this->UpdateWorldToDisplay())
+		{
+			return;
+		}
+		const double *B = this->DisplayToWorld;
+		double z = this->CachedPlaneZ;
+		double w1[3] = {
+			B[0] * p1[0] + B[1] * p1[1] + B[2], B[3] * p1[0] + B[4] * p1[1] + B[5], z };
+		double w2[3] = {
+			B[0] * p2[0] + B[1] * p2[1] + B[2], B[3] * p2[0] + B[4] * p2[1] + B[5], z };
+		this->SetWorldCorners(w1, w2);
+	}
+	else
+	{
+		double x1 = p1[0], y1 = p1[1];
+		double x2 = p2[0], y2 = p2[1];
+		DisplayToNormalizedViewport(this->Renderer, x1, y1);
+		DisplayToNormalizedViewport(this->Renderer, x2, y2);
+		this->PositionCoordinate->SetValue(x1, y1);
+		this->Position2Coordinate->SetValue(x2 - x1, y2 - y1);
+	}
+}
+
 //-------------------------------------------------------------------------
 void vtkEllipseRepresentation::GetActors2D(vtkPropCollection *pc)
 {
+	this->CreatePipeline();
+	if (this->FillActor)
+	{
+		pc->AddItem(this->FillActor);
+	}
+	if (this->RingActor)
+	{
+		pc->AddItem(this->RingActor);
+	}
 	pc->AddItem(this->EWActor);
 }
 
 //-------------------------------------------------------------------------
 void vtkEllipseRepresentation::ReleaseGraphicsResources(vtkWindow *w)
 {
-	this->EWActor->ReleaseGraphicsResources(w);
+	if (this->EWActor)
+	{
+		this->EWActor->ReleaseGraphicsResources(w);
+	}
+	if (this->RingActor)
+	{
+		this->RingActor->ReleaseGraphicsResources(w);
+	}
+	if (this->FillActor)
+	{
+		this->FillActor->ReleaseGraphicsResources(w);
+	}
 }
 
 //-------------------------------------------------------------------------
+// The overlay pass runs once per frame, it counts the frames the ellipse
+// has been culled for
 int vtkEllipseRepresentation::RenderOverlay(vtkViewport *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::RenderOverlay");
+
+	if (!this->IsInViewport())
+	{
+		if (this->EWActor && this->PipelineReleaseDelay > 0 &&
+			++this->CulledFrames >= this->PipelineReleaseDelay)
+		{
+			this->ReleasePipeline(w->GetVTKWindow());
+		}
+		return 0;
+	}
+	this->CulledFrames = 0;
+	this->CreatePipeline();
 	this->BuildRepresentation();
-	if (!this->EWActor->GetVisibility())
+	if (!this->Placed || !this->EWActor->GetVisibility())
 	{
 		return 0;
 	}
-	return this->EWActor->RenderOverlay(w);
+	int count = 0;
+	if (this->Fill)
+	{
+		count += this->FillActor->RenderOverlay(w);
+	}
+	if (this->Annulus)
+	{
+		count += this->RingActor->RenderOverlay(w);
+	}
+	return count + this->EWActor->RenderOverlay(w);
 }
 
 //-------------------------------------------------------------------------
 int vtkEllipseRepresentation::RenderOpaqueGeometry(vtkViewport *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::RenderOpaqueGeometry");
+
+	if (!this->IsInViewport())
+	{
+		return 0;
+	}
+	this->CreatePipeline();
 	this->BuildRepresentation();
-	if (!this->EWActor->GetVisibility())
+	if (!this->Placed || !this->EWActor->GetVisibility())
 	{
 		return 0;
 	}
-	return this->EWActor->RenderOpaqueGeometry(w);
+	int count = 0;
+	if (this->Fill)
+	{
+		count += this->FillActor->RenderOpaqueGeometry(w);
+	}
+	if (this->Annulus)
+	{
+		count += this->RingActor->RenderOpaqueGeometry(w);
+	}
+	return count + this->EWActor->RenderOpaqueGeometry(w);
 }
 
 //-----------------------------------------------------------------------------
 int vtkEllipseRepresentation::RenderTranslucentPolygonalGeometry(vtkViewport *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseRepresentation::RenderTranslucentPolygonalGeometry");
+
+	if (!this->IsInViewport())
+	{
+		return 0;
+	}
+	this->CreatePipeline();
 	this->BuildRepresentation();
-	if (!this->EWActor->GetVisibility())
+	if (!this->Placed || !this->EWActor->GetVisibility())
 	{
 		return 0;
 	}
-	return this->EWActor->RenderTranslucentPolygonalGeometry(w);
+	int count = 0;
+	if (this->Fill)
+	{
+		count += this->FillActor->RenderTranslucentPolygonalGeometry(w);
+	}
+	if (this->Annulus)
+	{
+		count += this->RingActor->RenderTranslucentPolygonalGeometry(w);
+	}
+	return count + this->EWActor->RenderTranslucentPolygonalGeometry(w);
 }
 
 //-----------------------------------------------------------------------------
@@ -393,12 +1126,19 @@ int vtkEllipseRepresentation::RenderTranslucentPolygonalGeometry(vtkViewport *w)
 // Does this prop have some translucent polygonal geometry?
 int vtkEllipseRepresentation::HasTranslucentPolygonalGeometry()
 {
+	if (!this->IsInViewport())
+	{
+		return 0;
+	}
+	this->CreatePipeline();
 	this->BuildRepresentation();
-	if (!this->EWActor->GetVisibility())
+	if (!this->Placed || !this->EWActor->GetVisibility())
 	{
 		return 0;
 	}
-	return this->EWActor->HasTranslucentPolygonalGeometry();
+	return this->EWActor->HasTranslucentPolygonalGeometry() ||
+		(this->Fill && this->FillActor->HasTranslucentPolygonalGeometry()) ||
+		(this->Annulus && this->RingActor->HasTranslucentPolygonalGeometry());
 }
 
 //-------------------------------------------------------------------------
@@ -430,11 +1170,39 @@ void vtkEllipseRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 		os << indent << "Ellipse Property: (none)\n";
 	}
 
+	os << indent << "Annulus: " << (this->Annulus ? "On\n" : "Off\n");
+	os << indent << "Annulus Inner Scale: " << this->AnnulusInnerScale << "\n";
+	os << indent << "Annulus Outer Scale: " << this->AnnulusOuterScale << "\n";
+	os << indent << "Ring Property:\n";
+	this->RingProperty->PrintSelf(os, indent.GetNextIndent());
+	os << indent << "Fill: " << (this->Fill ? "On\n" : "Off\n");
+	os << indent << "Fill Property:\n";
+	this->FillProperty->PrintSelf(os, indent.GetNextIndent());
+
+	os << indent << "Anchor Mode: "
+		<< (this->AnchorMode == ANCHOR_WORLD ? "World\n" : "Viewport\n");
+	if (this->Model)
+	{
+		os << indent << "Model: " << this->Model << "\n";
+	}
+	else
+	{
+		os << indent << "Model: (none)\n";
+	}
+
 	os << indent << "Proportional Resize: "
 		<< (this->ProportionalResize ? "On\n" : "Off\n");
 	os << indent << "Minimum Size: " << this->MinimumSize[0] << " " << this->MinimumSize[1] << endl;
 	os << indent << "Maximum Size: " << this->MaximumSize[0] << " " << this->MaximumSize[1] << endl;
 
+	os << indent << "Level Of Detail: " << (this->LevelOfDetail ? "On\n" : "Off\n");
+	os << indent << "Point LOD Size: " << this->PointLODSize << "\n";
+	os << indent << "Reduced LOD Size: " << this->ReducedLODSize << "\n";
+	os << indent << "Reduced Resolution: " << this->ReducedResolution << "\n";
+	os << indent << "Viewport Culling: " << (this->ViewportCulling ? "On\n" : "Off\n");
+	os << indent << "Pipeline Release Delay: " << this->PipelineReleaseDelay << "\n";
+	os << indent << "Pipeline: " << (this->EWActor ? "Created\n" : "(none)\n");
+
 	os << indent << "Moving: " << (this->Moving ? "On\n" : "Off\n");
 	os << indent << "Tolerance: " << this->Tolerance << "\n";
 
@@ -46,6 +46,8 @@ class vtkTransformPolyDataFilter;
 class vtkPolyDataMapper2D;
 class vtkActor2D;
 class vtkProperty2D;
+class vtkEllipseModel;
+class vtkAppendPolyData;
 
 //class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseRepresentation : public vtkWidgetRepresentation
 class vtkEllipseRepresentation : public vtkWidgetRepresentation
@@ -78,6 +80,59 @@ public:
 	vtkViewportCoordinateMacro(Position2);
 	//@}
 
+	enum { ANCHOR_VIEWPORT = 0, ANCHOR_WORLD };
+
+	//@{
+	/**
+	* Specify how the ellipse is anchored in the scene. With ANCHOR_VIEWPORT
+	* (the default) Position and Position2 are normalized viewport coordinates
+	* and the ellipse stays fixed on screen. With ANCHOR_WORLD Position and
+	* Position2 are the world coordinates of two opposite corners (Position2
+	* is absolute, not relative to Position) on the plane z = Position[2], so
+	* the ellipse follows the camera when it pans or zooms. Only a cached
+	* world-to-display affine is recomputed on camera or window changes; the
+	* canonical ellipse points are never re-tessellated. Switching modes
+	* preserves the on-screen location when a renderer is available.
+	*/
+	virtual void SetAnchorMode(int mode);
+	vtkGetMacro(AnchorMode, int);
+	void SetAnchorModeToViewport() { this->SetAnchorMode(ANCHOR_VIEWPORT); }
+	void SetAnchorModeToWorld() { this->SetAnchorMode(ANCHOR_WORLD); }
+	//@}
+
+	//@{
+	/**
+	* Share the ellipse geometry with other representations, e.g., the views
+	* of the same ROI in linked multi-planar renderers. When a model is set,
+	* the representation switches to world anchored mode and reads and writes
+	* its corners from the model instead of Position and Position2; each
+	* representation only keeps its own cached world-to-display transform.
+	*/
+	virtual void SetModel(vtkEllipseModel *model);
+	vtkGetObjectMacro(Model, vtkEllipseModel);
+	//@}
+
+	//@{
+	/**
+	* Get/set the lower left and upper right corners of the rectangle bounding
+	* the ellipse in display coordinates, independent of the anchor mode.
+	* GetDisplayCorners() returns 0 if no renderer (or render window) is
+	* available to resolve the coordinates.
+	*/
+	int GetDisplayCorners(double p1[2], double p2[2]);
+	void SetDisplayCorners(const double p1[2], const double p2[2]);
+	//@}
+
+	//@{
+	/**
+	* Get/set two opposite corners of the rectangle bounding the ellipse in
+	* world coordinates, read from and written to the model when one is set.
+	* Only meaningful in world anchored mode.
+	*/
+	void GetWorldCorners(double w1[3], double w2[3]);
+	void SetWorldCorners(const double w1[3], const double w2[3]);
+	//@}
+
 	enum { ELLIPSE_OFF = 0, ELLIPSE_ON, ELLIPSE_ACTIVE };
 
 	//@{
@@ -126,6 +181,40 @@ public:
 	vtkGetObjectMacro(EllipseProperty, vtkProperty2D);
 	//@}
 
+	//@{
+	/**
+	* Draw a concentric background ring around the ellipse, e.g., to show the
+	* region whose statistics vtkEllipseStatistics computes with its Annulus
+	* option. The ring is bounded by the ellipse scaled by AnnulusInnerScale
+	* (1 by default) and by AnnulusOuterScale (1.5 by default) about its
+	* center, and drawn with RingProperty. Off by default.
+	*/
+	vtkSetMacro(Annulus, vtkTypeBool);
+	vtkGetMacro(Annulus, vtkTypeBool);
+	vtkBooleanMacro(Annulus, vtkTypeBool);
+	vtkSetClampMacro(AnnulusInnerScale, double, 1.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(AnnulusInnerScale, double);
+	vtkSetClampMacro(AnnulusOuterScale, double, 1.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(AnnulusOuterScale, double);
+	vtkGetObjectMacro(RingProperty, vtkProperty2D);
+	//@}
+
+	//@{
+	/**
+	* Fill the interior of the ellipse with FillProperty (white, with an
+	* opacity of 0.3 by default), e.g., to show overlapping ROIs. The fill is
+	* a single triangle strip over the points of the outline; its
+	* connectivity is shared by all the representations of the same
+	* resolution and only the transformed points are owned by each
+	* representation, so a drag only updates vertex positions. Off by
+	* default.
+	*/
+	vtkSetMacro(Fill, vtkTypeBool);
+	vtkGetMacro(Fill, vtkTypeBool);
+	vtkBooleanMacro(Fill, vtkTypeBool);
+	vtkGetObjectMacro(FillProperty, vtkProperty2D);
+	//@}
+
 	//@{
 	/**
 	* Indicate whether resizing operations should keep the x-y directions
@@ -161,6 +250,56 @@ public:
 	vtkGetMacro(Tolerance, int);
 	//@}
 
+	//@{
+	/**
+	* Control the level of detail used to draw the ellipse. When LevelOfDetail
+	* is on, ellipses whose on-screen extent is smaller than PointLODSize pixels
+	* are drawn as a small quad, and ellipses smaller than ReducedLODSize pixels
+	* use ReducedResolution points instead of the full resolution. The
+	* tessellations are shared by all representations. On by default.
+	*/
+	vtkSetMacro(LevelOfDetail, vtkTypeBool);
+	vtkGetMacro(LevelOfDetail, vtkTypeBool);
+	vtkBooleanMacro(LevelOfDetail, vtkTypeBool);
+	vtkSetClampMacro(PointLODSize, int, 0, VTK_INT_MAX);
+	vtkGetMacro(PointLODSize, int);
+	vtkSetClampMacro(ReducedLODSize, int, 0, VTK_INT_MAX);
+	vtkGetMacro(ReducedLODSize, int);
+	vtkSetClampMacro(ReducedResolution, int, 4, VTK_INT_MAX);
+	vtkGetMacro(ReducedResolution, int);
+	//@}
+
+	//@{
+	/**
+	* When ViewportCulling is on, an ellipse that lies completely outside of
+	* its renderer's viewport is neither built nor rendered, so frame time
+	* scales with the number of visible ellipses. On by default.
+	*/
+	vtkSetMacro(ViewportCulling, vtkTypeBool);
+	vtkGetMacro(ViewportCulling, vtkTypeBool);
+	vtkBooleanMacro(ViewportCulling, vtkTypeBool);
+	//@}
+
+	//@{
+	/**
+	* The transforms, filters, mappers and actors drawing the ellipse are only
+	* created when it is first rendered (or GetActors2D() is called), so that
+	* a representation that was never visible only holds the state of the
+	* ellipse. When PipelineReleaseDelay is positive, they are deleted again
+	* once the ellipse has been culled for that many consecutive frames. 0 (the
+	* default) keeps them until the representation is deleted.
+	*/
+	vtkSetClampMacro(PipelineReleaseDelay, int, 0, VTK_INT_MAX);
+	vtkGetMacro(PipelineReleaseDelay, int);
+	//@}
+
+	/**
+	* Return the approximate memory used by this representation, in bytes,
+	* including its rendering pipeline when it exists. The canonical outlines
+	* shared by all representations are not counted.
+	*/
+	vtkIdType GetMemoryFootprint();
+
 	//@{
 	/**
 	* After a selection event within the region interior to the Ellipse; the
@@ -245,8 +384,33 @@ protected:
 	vtkCoordinate *PositionCoordinate;
 	vtkCoordinate *Position2Coordinate;
 
+	// World anchoring. The world-to-display affine of the plane z = Position[2]
+	// is cached as display = A * (x, y, 1) and only recomputed when the
+	// camera, renderer or window changes.
+	int AnchorMode;
+	double WorldToDisplay[6];
+	double DisplayToWorld[6];
+	double DisplayToViewportOffset[2];
+	double CachedPlaneZ;
+	vtkMTimeType CachedCameraMTime;
+	vtkMTimeType CachedRendererMTime;
+	vtkMTimeType CachedWindowMTime;
+	vtkViewport *CachedViewport;
+	vtkTimeStamp WorldToDisplayTime;
+	int UpdateWorldToDisplay();
+
+	// 0 while a world anchored ellipse cannot be placed in the view (its
+	// plane is seen edge on, e.g., an axial ROI in a sagittal view); the
+	// actors are then not rendered instead of keeping their last transform
+	int Placed;
+
+	// Shared geometry. World corners are read from and written to the model
+	// when one is set, or to Position/Position2 otherwise.
+	vtkEllipseModel *Model;
+
 	// Sometimes subclasses must negotiate with their superclasses
-	// to achieve the correct layout.
+	// to achieve the correct layout. Does nothing by default; overrides must
+	// not modify EWPoints or EWPolyData.
 	int Negotiated;
 	virtual void NegotiateLayout();
 
@@ -260,13 +424,63 @@ protected:
 
 	// Ellipse representation. Subclasses may use the EWTransform class
 	// to transform their geometry into the region surrounded by the Ellipse.
+	// EWPolyData and EWPoints are the canonical outline of the resolution,
+	// shared by every representation of the process: they are read only, and
+	// writing to them would change all the ellipses of that resolution.
+	// Subclasses needing other geometry must build their own polydata.
 	vtkPoints                  *EWPoints;
 	vtkPolyData                *EWPolyData;
+
+	// Return the canonical outline of the given resolution, shared by all
+	// representations. The returned polydata must not be modified.
+	static vtkPolyData *GetCanonicalOutline(int resolution);
+
+	// Return the canonical interior of the given resolution: the points of
+	// the canonical outline and a shared triangle strip. The returned
+	// polydata must not be modified.
+	static vtkPolyData *GetCanonicalFill(int resolution);
+
+	// Level of detail and culling
+	vtkTypeBool LevelOfDetail;
+	vtkTypeBool ViewportCulling;
+	int PointLODSize;
+	int ReducedLODSize;
+	int ReducedResolution;
+	int CurrentResolution;
+	int IsInViewport();
 	vtkTransform               *EWTransform;
 	vtkTransformPolyDataFilter *EWTransformFilter;
 	vtkPolyDataMapper2D        *EWMapper;
 	vtkActor2D                 *EWActor;
 
+	// Lazy creation and release of the rendering pipeline
+	int PipelineReleaseDelay;
+	int CulledFrames;
+	vtkTimeStamp PipelineTime;
+	void CreatePipeline();
+	void ReleasePipeline(vtkWindow *w);
+
+	// Background ring: the inner and outer outlines are scaled copies of the
+	// canonical outline, appended into a single actor
+	vtkTypeBool Annulus;
+	double AnnulusInnerScale;
+	double AnnulusOuterScale;
+	vtkProperty2D              *RingProperty;
+	vtkTransform               *RingInnerTransform;
+	vtkTransform               *RingOuterTransform;
+	vtkTransformPolyDataFilter *RingInnerTransformFilter;
+	vtkTransformPolyDataFilter *RingOuterTransformFilter;
+	vtkAppendPolyData          *RingAppend;
+	vtkPolyDataMapper2D        *RingMapper;
+	vtkActor2D                 *RingActor;
+
+	// Interior, transformed by EWTransform
+	vtkTypeBool Fill;
+	vtkProperty2D              *FillProperty;
+	vtkTransformPolyDataFilter *FillTransformFilter;
+	vtkPolyDataMapper2D        *FillMapper;
+	vtkActor2D                 *FillActor;
+
 	// Constraints on size
 	int MinimumSize[2];
 	int MaximumSize[2];
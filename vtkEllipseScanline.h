@@ -0,0 +1,206 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseScanline.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseScanline
+* @brief   analytic scanline spans of an axis aligned ellipse on a pixel grid
+*
+* vtkEllipseScanline computes, row by row, which pixels of a regular grid
+* are covered by an axis aligned ellipse given in continuous index
+* coordinates (pixel (i,j) is centered on (i,j) and covers the unit square
+* around it). Spans are computed analytically from the ellipse equation
+* ((x-cx)/rx)^2 + ((y-cy)/ry)^2 <= 1 with one square root per row, so that
+* the callers never test pixels one by one.
+*
+* This is a lightweight, header only helper shared by the ROI statistics,
+* rasterization and analytics classes; it is not a vtkObject.
+*/
+
+#ifndef vtkEllipseScanline_h
+#define vtkEllipseScanline_h
+
+#include <algorithm>
+#include <cmath>
+
+class vtkEllipseScanline
+{
+public:
+	vtkEllipseScanline()
+	{
+		this->Center[0] = this->Center[1] = 0.0;
+		this->Radius[0] = this->Radius[1] = 0.0;
+	}
+
+	vtkEllipseScanline(const double center[2], const double radius[2])
+	{
+		this->SetEllipse(center, radius);
+	}
+
+	void SetEllipse(const double center[2], const double radius[2])
+	{
+		this->Center[0] = center[0];
+		this->Center[1] = center[1];
+		this->Radius[0] = std::fabs(radius[0]);
+		this->Radius[1] = std::fabs(radius[1]);
+	}
+
+	const double *GetCenter() const { return this->Center; }
+	const double *GetRadius() const { return this->Radius; }
+
+	/**
+	* Return 0 if the ellipse is degenerate (a zero semi-axis).
+	*/
+	bool IsValid() const
+	{
+		return this->Radius[0] > 0.0 && this->Radius[1] > 0.0;
+	}
+
+	/**
+	* Rows whose pixel squares may intersect the ellipse. The range is not
+	* clamped to any extent.
+	*/
+	void GetRowRange(int &j0, int &j1) const
+	{
+		j0 = static_cast<int>(std::ceil(this->Center[1] - this->Radius[1] - 0.5));
+		j1 = static_cast<int>(std::floor(this->Center[1] + this->Radius[1] + 0.5));
+	}
+
+	/**
+	* Columns whose pixel squares may intersect the ellipse.
+	*/
+	void GetColumnRange(int &i0, int &i1) const
+	{
+		i0 = static_cast<int>(std::ceil(this->Center[0] - this->Radius[0] - 0.5));
+		i1 = static_cast<int>(std::floor(this->Center[0] + this->Radius[0] + 0.5));
+	}
+
+	/**
+	* Chord of the ellipse at the continuous ordinate y. Returns false if the
+	* line does not cross the ellipse.
+	*/
+	bool GetChord(double y, double &x0, double &x1) const
+	{
+		double v = (y - this->Center[1]) / this->Radius[1];
+		double t = 1.0 - v * v;
+		if (t < 0.0)
+		{
+			return false;
+		}
+		double half = this->Radius[0] * std::sqrt(t);
+		x0 = this->Center[0] - half;
+		x1 = this->Center[0] + half;
+		return true;
+	}
+
+	/**
+	* Pixels of row j whose centers are inside the ellipse. Returns false if
+	* the span is empty.
+	*/
+	bool GetSpan(int j, int &i0, int &i1) const
+	{
+		double x0, x1;
+		if (!this->GetChord(static_cast<double>(j), x0, x1))
+		{
+			return false;
+		}
+		i0 = static_cast<int>(std::ceil(x0));
+		i1 = static_cast<int>(std::floor(x1));
+		return i0 <= i1;
+	}
+
+	/**
+	* Classify the pixels of row j by coverage: [full0,full1] are the pixels
+	* whose whole square is inside the ellipse, and [touch0,touch1] the pixels
+	* whose square may intersect it. Pixels of the touch span outside of the
+	* full span are the boundary pixels. The full span may be empty
+	* (full0 > full1). Returns false if no pixel of the row is touched.
+	*/
+	bool GetCoverageSpans(int j, int &full0, int &full1, int &touch0, int &touch1) const
+	{
+		double yLow = j - 0.5;
+		double yHigh = j + 0.5;
+		double cy = this->Center[1];
+		if (yHigh < cy - this->Radius[1] || yLow > cy + this->Radius[1])
+		{
+			return false;
+		}
+
+		// The widest chord over the row is at the ordinate closest to the center
+		double yWide = std::min(std::max(cy, yLow), yHigh);
+		double w0, w1;
+		if (!this->GetChord(yWide, w0, w1))
+		{
+			return false;
+		}
+		touch0 = static_cast<int>(std::ceil(w0 - 0.5));
+		touch1 = static_cast<int>(std::floor(w1 + 0.5));
+
+		// The narrowest chord is at one of the row edges
+		double l0, l1, h0, h1;
+		full0 = 1;
+		full1 = 0;
+		if (this->GetChord(yLow, l0, l1) && this->GetChord(yHigh, h0, h1))
+		{
+			full0 = static_cast<int>(std::ceil(std::max(l0, h0) + 0.5));
+			full1 = static_cast<int>(std::floor(std::min(l1, h1) - 0.5));
+		}
+		return touch0 <= touch1;
+	}
+
+	/**
+	* Compute the chords of n sub-rows evenly spread over row j, to be passed
+	* to Coverage(). Empty chords have x0 > x1.
+	*/
+	void GetSubChords(int j, int n, double *x0, double *x1) const
+	{
+		for (int k = 0; k < n; k++)
+		{
+			double y = j - 0.5 + (k + 0.5) / n;
+			if (!this->GetChord(y, x0[k], x1[k]))
+			{
+				x0[k] = 1.0;
+				x1[k] = 0.0;
+			}
+		}
+	}
+
+	/**
+	* Fraction of the square of pixel i covered by the ellipse, given the sub
+	* chords of its row. The coverage is exact along x and sampled along y.
+	*/
+	static double Coverage(int i, int n, const double *x0, const double *x1)
+	{
+		double left = i - 0.5;
+		double right = i + 0.5;
+		double covered = 0.0;
+		for (int k = 0; k < n; k++)
+		{
+			double length = std::min(x1[k], right) - std::max(x0[k], left);
+			covered += (length > 0.0 ? length : 0.0);
+		}
+		return covered / n;
+	}
+
+	/**
+	* Evaluate the implicit function ((x-cx)/rx)^2 + ((y-cy)/ry)^2.
+	*/
+	double Evaluate(double x, double y) const
+	{
+		double u = (x - this->Center[0]) / this->Radius[0];
+		double v = (y - this->Center[1]) / this->Radius[1];
+		return u * u + v * v;
+	}
+
+private:
+	double Center[2];
+	double Radius[2];
+};
+
+#endif
@@ -0,0 +1,882 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseStatistics.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseStatistics.h"
+#include "vtkEllipseScanline.h"
+#include "vtkEllipseStatisticsCache.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMatrix4x4.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseStatistics);
+
+//-------------------------------------------------------------------------
+// Samplers give the functor access to the pixels of the rows of the ellipse.
+// ClipRows() and ClipSpan() restrict the rows and spans to the available
+// data, and ForEach() calls op(i, value) for every pixel of a clipped span.
+
+// The pixels of an axis aligned slice.
+template <class T>
+class vtkEllipseSliceSampler
+{
+public:
+	const T *Base; // first pixel of the extent on the slice
+	vtkIdType Increments[2];
+	int Extent[4];
+
+	void ClipRows(int &j0, int &j1) const
+	{
+		j0 = std::max(j0, this->Extent[2]);
+		j1 = std::min(j1, this->Extent[3]);
+	}
+
+	bool ClipSpan(int vtkNotUsed(j), int &i0, int &i1) const
+	{
+		i0 = std::max(i0, this->Extent[0]);
+		i1 = std::min(i1, this->Extent[1]);
+		return i0 <= i1;
+	}
+
+	template <class Op>
+	void ForEach(int j, int i0, int i1, Op &&op) const
+	{
+		const T *p = this->Base + (j - this->Extent[2]) * this->Increments[1] +
+			(i0 - this->Extent[0]) * this->Increments[0];
+		for (int i = i0; i <= i1; i++, p += this->Increments[0])
+		{
+			op(i, static_cast<double>(*p));
+		}
+	}
+};
+
+// The pixels of an oblique plane, interpolated from the volume. Pixel (i, j)
+// of the plane is at Origin + i * U + j * V in continuous volume index
+// coordinates; spans are walked by adding U.
+template <class T, int Mode>
+class vtkEllipseResliceSampler
+{
+public:
+	const T *Base; // first voxel of the extent
+	vtkIdType Increments[3];
+	int Extent[6];
+	double Origin[3];
+	double U[3];
+	double V[3];
+
+	void ClipRows(int &vtkNotUsed(j0), int &vtkNotUsed(j1)) const
+	{
+	}
+
+	// Keep the pixels whose sample point falls in the volume
+	bool ClipSpan(int j, int &i0, int &i1) const
+	{
+		const double margin = (Mode == vtkEllipseStatistics::NEAREST ? 0.5 : 0.0);
+		double lo = i0;
+		double hi = i1;
+		for (int a = 0; a < 3; a++)
+		{
+			double q = this->Origin[a] + j * this->V[a];
+			double l = this->Extent[2 * a] - margin;
+			double h = this->Extent[2 * a + 1] + margin;
+			if (fabs(this->U[a]) < 1e-12)
+			{
+				if (q < l || q > h)
+				{
+					return false;
+				}
+				continue;
+			}
+			double s0 = (l - q) / this->U[a];
+			double s1 = (h - q) / this->U[a];
+			lo = std::max(lo, std::min(s0, s1));
+			hi = std::min(hi, std::max(s0, s1));
+		}
+		if (lo > hi)
+		{
+			return false;
+		}
+		// Sample points on the boundary of the volume are kept despite round
+		// off, Sample() clamps them anyway
+		i0 = static_cast<int>(ceil(lo - 1e-9));
+		i1 = static_cast<int>(floor(hi + 1e-9));
+		return i0 <= i1;
+	}
+
+	template <class Op>
+	void ForEach(int j, int i0, int i1, Op &&op) const
+	{
+		double p[3];
+		for (int a = 0; a < 3; a++)
+		{
+			p[a] = this->Origin[a] + i0 * this->U[a] + j * this->V[a];
+		}
+		for (int i = i0; i <= i1; i++)
+		{
+			op(i, this->Sample(p));
+			p[0] += this->U[0];
+			p[1] += this->U[1];
+			p[2] += this->U[2];
+		}
+	}
+
+	double Sample(const double p[3]) const
+	{
+		vtkIdType offset = 0;
+		if (Mode == vtkEllipseStatistics::NEAREST)
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				int k = static_cast<int>(floor(p[a] + 0.5));
+				k = std::min(std::max(k, this->Extent[2 * a]), this->Extent[2 * a + 1]);
+				offset += (k - this->Extent[2 * a]) * this->Increments[a];
+			}
+			return static_cast<double>(this->Base[offset]);
+		}
+
+		double t[3];
+		vtkIdType step[3];
+		for (int a = 0; a < 3; a++)
+		{
+			double f = floor(p[a]);
+			int k = static_cast<int>(f);
+			t[a] = p[a] - f;
+			if (k < this->Extent[2 * a])
+			{
+				k = this->Extent[2 * a];
+				t[a] = 0.0;
+			}
+			if (k >= this->Extent[2 * a + 1])
+			{
+				k = this->Extent[2 * a + 1];
+				t[a] = 0.0;
+			}
+			step[a] = (k < this->Extent[2 * a + 1]) ? this->Increments[a] : 0;
+			offset += (k - this->Extent[2 * a]) * this->Increments[a];
+		}
+		const T *v = this->Base + offset;
+		double c00 = v[0] + t[0] * (v[step[0]] - static_cast<double>(v[0]));
+		double c10 = v[step[1]] + t[0] * (v[step[1] + step[0]] - static_cast<double>(v[step[1]]));
+		v += step[2];
+		double c01 = v[0] + t[0] * (v[step[0]] - static_cast<double>(v[0]));
+		double c11 = v[step[1]] + t[0] * (v[step[1] + step[0]] - static_cast<double>(v[step[1]]));
+		double c0 = c00 + t[1] * (c10 - c00);
+		double c1 = c01 + t[1] * (c11 - c01);
+		return c0 + t[2] * (c1 - c0);
+	}
+};
+
+//-------------------------------------------------------------------------
+// Accumulate the pixels of the ellipse row by row. Each thread owns its
+// accumulator; they are merged once all the rows are done. In reproducible
+// mode the range of operator() is a range of chunks of rows instead, and
+// each chunk is summed into its own accumulator.
+template <class TSampler>
+class vtkEllipseStatisticsFunctor
+{
+public:
+	TSampler Source;
+	vtkEllipseScanline Scanline;
+	int BoundaryMode;
+	int SubSamples;
+
+	// Background ring between the Inner and Outer ellipses
+	bool Annulus;
+	vtkEllipseScanline Inner;
+	vtkEllipseScanline Outer;
+
+	vtkSMPThreadLocal<vtkEllipseStatisticsAccumulator> Accumulator;
+	vtkSMPThreadLocal<vtkEllipseStatisticsAccumulator> RingAccumulator;
+	vtkSMPThreadLocal<std::vector<double> > SubChords;
+
+	// Reproducible mode, over the rows [RowBegin, RowEnd)
+	bool Reproducible = false;
+	bool Compensated = false;
+	vtkIdType RowBegin = 0;
+	vtkIdType RowEnd = 0;
+	std::vector<vtkEllipseStatisticsAccumulator> Chunks;
+	std::vector<vtkEllipseStatisticsAccumulator> RingChunks;
+	std::vector<vtkEllipseCompensatedAccumulator> CompensatedChunks;
+	std::vector<vtkEllipseCompensatedAccumulator> CompensatedRingChunks;
+
+	explicit vtkEllipseStatisticsFunctor(const TSampler &source)
+		: Source(source)
+	{
+	}
+
+	void Initialize()
+	{
+		// sub chords of the ellipse, then of the outer and inner ring ellipses
+		this->SubChords.Local().resize(6 * this->SubSamples);
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		if (!this->Reproducible)
+		{
+			this->Rows(begin, end, this->Accumulator.Local(), this->RingAccumulator.Local());
+			return;
+		}
+		const vtkIdType size = vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE;
+		for (vtkIdType c = begin; c < end; c++)
+		{
+			vtkIdType j0 = this->RowBegin + c * size;
+			vtkIdType j1 = std::min(j0 + size, this->RowEnd);
+			if (this->Compensated)
+			{
+				this->Rows(j0, j1, this->CompensatedChunks[c], this->CompensatedRingChunks[c]);
+			}
+			else
+			{
+				this->Rows(j0, j1, this->Chunks[c], this->RingChunks[c]);
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+
+	template <class TAccumulator>
+	void Rows(vtkIdType begin, vtkIdType end, TAccumulator &acc, TAccumulator &ring)
+	{
+		for (vtkIdType j = begin; j < end; j++)
+		{
+			if (this->BoundaryMode == vtkEllipseStatistics::PARTIAL_VOLUME)
+			{
+				this->PartialVolumeRow(static_cast<int>(j), acc);
+				if (this->Annulus)
+				{
+					this->PartialVolumeRingRow(static_cast<int>(j), ring);
+				}
+			}
+			else
+			{
+				this->BinaryRow(static_cast<int>(j), acc);
+				if (this->Annulus)
+				{
+					this->BinaryRingRow(static_cast<int>(j), ring);
+				}
+			}
+		}
+	}
+
+	template <class TAccumulator>
+	void BinaryRow(int j, TAccumulator &acc)
+	{
+		int i0, i1;
+		if (!this->Scanline.GetSpan(j, i0, i1) || !this->Source.ClipSpan(j, i0, i1))
+		{
+			return;
+		}
+		this->Source.ForEach(j, i0, i1, [&acc](int, double value) { acc.Add(value); });
+	}
+
+	template <class TAccumulator>
+	void PartialVolumeRow(int j, TAccumulator &acc)
+	{
+		int f0, f1, t0, t1;
+		if (!this->Scanline.GetCoverageSpans(j, f0, f1, t0, t1) ||
+			!this->Source.ClipSpan(j, t0, t1))
+		{
+			return;
+		}
+		if (f0 > f1)
+		{
+			// no fully covered pixel, the whole row is boundary
+			f0 = t1 + 1;
+			f1 = t1;
+		}
+		int leftEnd = std::min(f0 - 1, t1);
+		int rightBegin = std::max(f1 + 1, std::max(leftEnd + 1, t0));
+		int fullBegin = std::max(leftEnd + 1, t0);
+		int fullEnd = std::min(rightBegin - 1, t1);
+
+		// Interior pixels at full speed
+		this->Source.ForEach(j, fullBegin, fullEnd,
+			[&acc](int, double value) { acc.Add(value); });
+
+		// Boundary pixels weighted by their coverage
+		if (t0 <= leftEnd || rightBegin <= t1)
+		{
+			std::vector<double> &chords = this->SubChords.Local();
+			const int n = this->SubSamples;
+			double *x0 = chords.data();
+			double *x1 = x0 + n;
+			this->Scanline.GetSubChords(j, n, x0, x1);
+			auto weighted = [&acc, n, x0, x1](int i, double value)
+			{
+				double w = vtkEllipseScanline::Coverage(i, n, x0, x1);
+				if (w > 0.0)
+				{
+					acc.Add(value, w);
+				}
+			};
+			this->Source.ForEach(j, t0, leftEnd, weighted);
+			this->Source.ForEach(j, rightBegin, t1, weighted);
+		}
+	}
+
+	template <class Op>
+	void ClippedForEach(int j, int i0, int i1, Op &&op)
+	{
+		if (i0 <= i1 && this->Source.ClipSpan(j, i0, i1))
+		{
+			this->Source.ForEach(j, i0, i1, op);
+		}
+	}
+
+	// The span of the outer ellipse minus the span of the inner one
+	template <class TAccumulator>
+	void BinaryRingRow(int j, TAccumulator &ring)
+	{
+		int c0, c1, b0, b1;
+		if (!this->Outer.GetSpan(j, c0, c1))
+		{
+			return;
+		}
+		auto add = [&ring](int, double value) { ring.Add(value); };
+		if (!this->Inner.GetSpan(j, b0, b1))
+		{
+			this->ClippedForEach(j, c0, c1, add);
+			return;
+		}
+		this->ClippedForEach(j, c0, std::min(c1, b0 - 1), add);
+		this->ClippedForEach(j, std::max(c0, b1 + 1), c1, add);
+	}
+
+	// The coverage of the ring is the coverage of the outer ellipse minus the
+	// coverage of the inner one. The row is cut at the ends of the full and
+	// touched spans of both ellipses into segments over which the pixels are
+	// either fully inside the ring, fully inside the inner ellipse (skipped),
+	// or on a boundary and weighted.
+	template <class TAccumulator>
+	void PartialVolumeRingRow(int j, TAccumulator &ring)
+	{
+		int fo0, fo1, to0, to1;
+		if (!this->Outer.GetCoverageSpans(j, fo0, fo1, to0, to1) ||
+			!this->Source.ClipSpan(j, to0, to1))
+		{
+			return;
+		}
+		int fi0 = 1, fi1 = 0, ti0 = 1, ti1 = 0;
+		if (!this->Inner.GetCoverageSpans(j, fi0, fi1, ti0, ti1))
+		{
+			ti0 = 1;
+			ti1 = 0;
+		}
+
+		int cuts[8] = { to0, to1 + 1, fo0, fo1 + 1, ti0, ti1 + 1, fi0, fi1 + 1 };
+		std::sort(cuts, cuts + 8);
+
+		const int n = this->SubSamples;
+		double *xo0 = this->SubChords.Local().data() + 2 * n;
+		double *xo1 = xo0 + n;
+		double *xi0 = xo1 + n;
+		double *xi1 = xi0 + n;
+		bool chords = false;
+
+		int begin = to0;
+		for (int c = 0; c < 8; c++)
+		{
+			if (cuts[c] <= begin)
+			{
+				continue;
+			}
+			int end = std::min(cuts[c], to1 + 1) - 1;
+			bool inFo = fo0 <= begin && begin <= fo1;
+			bool inTi = ti0 <= begin && begin <= ti1;
+			bool inFi = fi0 <= begin && begin <= fi1;
+			if (!inFi)
+			{
+				if (inFo && !inTi)
+				{
+					this->Source.ForEach(j, begin, end,
+						[&ring](int, double value) { ring.Add(value); });
+				}
+				else
+				{
+					if (!chords)
+					{
+						this->Outer.GetSubChords(j, n, xo0, xo1);
+						this->Inner.GetSubChords(j, n, xi0, xi1);
+						chords = true;
+					}
+					this->Source.ForEach(j, begin, end,
+						[&ring, n, inFo, inTi, xo0, xo1, xi0, xi1](int i, double value)
+					{
+						double w = (inFo ? 1.0 : vtkEllipseScanline::Coverage(i, n, xo0, xo1)) -
+							(inTi ? vtkEllipseScanline::Coverage(i, n, xi0, xi1) : 0.0);
+						if (w > 0.0)
+						{
+							ring.Add(value, w);
+						}
+					});
+				}
+			}
+			begin = end + 1;
+			if (begin > to1)
+			{
+				break;
+			}
+		}
+	}
+};
+
+//-------------------------------------------------------------------------
+template <class TSampler>
+void vtkEllipseStatisticsExecute(vtkEllipseStatistics *self, const TSampler &sampler,
+	const vtkEllipseScanline &scanline, vtkEllipseStatisticsAccumulator &result,
+	vtkEllipseStatisticsAccumulator &ringResult)
+{
+	vtkEllipseStatisticsFunctor<TSampler> functor(sampler);
+	functor.Scanline = scanline;
+	functor.BoundaryMode = self->GetBoundaryMode();
+	functor.SubSamples = self->GetSubSamples();
+
+	// The ring is scaled about the center of the ellipse; the outer ellipse
+	// contains both regions, so its rows are the ones to traverse
+	functor.Annulus = self->GetAnnulus() &&
+		self->GetAnnulusOuterScale() > self->GetAnnulusInnerScale();
+	const vtkEllipseScanline &rows = functor.Annulus ? functor.Outer : scanline;
+	if (functor.Annulus)
+	{
+		const double *radius = scanline.GetRadius();
+		double inner[2] = {
+			radius[0] * self->GetAnnulusInnerScale(),
+			radius[1] * self->GetAnnulusInnerScale() };
+		double outer[2] = {
+			radius[0] * self->GetAnnulusOuterScale(),
+			radius[1] * self->GetAnnulusOuterScale() };
+		functor.Inner.SetEllipse(scanline.GetCenter(), inner);
+		functor.Outer.SetEllipse(scanline.GetCenter(), outer);
+	}
+
+	int j0, j1;
+	rows.GetRowRange(j0, j1);
+	sampler.ClipRows(j0, j1);
+	if (j0 > j1)
+	{
+		return;
+	}
+
+	if (self->GetReproducible())
+	{
+		// One accumulator per chunk, merged in a fixed order
+		const vtkIdType size = vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE;
+		vtkIdType chunks = (j1 - j0 + size) / size;
+		functor.Reproducible = true;
+		functor.Compensated = self->GetCompensatedSummation() != 0;
+		functor.RowBegin = j0;
+		functor.RowEnd = j1 + 1;
+		if (functor.Compensated)
+		{
+			functor.CompensatedChunks.resize(chunks);
+			functor.CompensatedRingChunks.resize(chunks);
+			vtkSMPTools::For(0, chunks, 1, functor);
+			vtkEllipseStatisticsPairwiseMerge(functor.CompensatedChunks);
+			vtkEllipseStatisticsPairwiseMerge(functor.CompensatedRingChunks);
+			result = functor.CompensatedChunks[0].GetResult();
+			ringResult = functor.CompensatedRingChunks[0].GetResult();
+		}
+		else
+		{
+			functor.Chunks.resize(chunks);
+			functor.RingChunks.resize(chunks);
+			vtkSMPTools::For(0, chunks, 1, functor);
+			vtkEllipseStatisticsPairwiseMerge(functor.Chunks);
+			vtkEllipseStatisticsPairwiseMerge(functor.RingChunks);
+			result = functor.Chunks[0];
+			ringResult = functor.RingChunks[0];
+		}
+		return;
+	}
+
+	vtkSMPTools::For(j0, j1 + 1, functor);
+
+	for (auto it = functor.Accumulator.begin(); it != functor.Accumulator.end(); ++it)
+	{
+		result.Merge(*it);
+	}
+	for (auto it = functor.RingAccumulator.begin(); it != functor.RingAccumulator.end(); ++it)
+	{
+		ringResult.Merge(*it);
+	}
+}
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseStatisticsSliceExecute(vtkEllipseStatistics *self, const T *base,
+	const vtkIdType increments[3], const int extent[6], const vtkEllipseScanline &scanline,
+	vtkEllipseStatisticsAccumulator &result, vtkEllipseStatisticsAccumulator &ringResult)
+{
+	vtkEllipseSliceSampler<T> sampler;
+	sampler.Base = base;
+	sampler.Increments[0] = increments[0];
+	sampler.Increments[1] = increments[1];
+	std::copy(extent, extent + 4, sampler.Extent);
+	vtkEllipseStatisticsExecute(self, sampler, scanline, result, ringResult);
+}
+
+//-------------------------------------------------------------------------
+template <class T, int Mode>
+void vtkEllipseStatisticsResliceExecute(vtkEllipseStatistics *self, const T *base,
+	const vtkIdType increments[3], const int extent[6], const double origin[3],
+	const double u[3], const double v[3], const vtkEllipseScanline &scanline,
+	vtkEllipseStatisticsAccumulator &result, vtkEllipseStatisticsAccumulator &ringResult)
+{
+	vtkEllipseResliceSampler<T, Mode> sampler;
+	sampler.Base = base;
+	std::copy(increments, increments + 3, sampler.Increments);
+	std::copy(extent, extent + 6, sampler.Extent);
+	std::copy(origin, origin + 3, sampler.Origin);
+	std::copy(u, u + 3, sampler.U);
+	std::copy(v, v + 3, sampler.V);
+	vtkEllipseStatisticsExecute(self, sampler, scanline, result, ringResult);
+}
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipseStatisticsResliceExecute(vtkEllipseStatistics *self, const T *base,
+	const vtkIdType increments[3], const int extent[6], const double origin[3],
+	const double u[3], const double v[3], const vtkEllipseScanline &scanline,
+	vtkEllipseStatisticsAccumulator &result, vtkEllipseStatisticsAccumulator &ringResult)
+{
+	if (self->GetInterpolationMode() == vtkEllipseStatistics::LINEAR)
+	{
+		vtkEllipseStatisticsResliceExecute<T, vtkEllipseStatistics::LINEAR>(self, base,
+			increments, extent, origin, u, v, scanline, result, ringResult);
+	}
+	else
+	{
+		vtkEllipseStatisticsResliceExecute<T, vtkEllipseStatistics::NEAREST>(self, base,
+			increments, extent, origin, u, v, scanline, result, ringResult);
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseStatistics::vtkEllipseStatistics()
+{
+	this->Input = nullptr;
+	this->Center[0] = this->Center[1] = 0.0;
+	this->Radius[0] = this->Radius[1] = 1.0;
+	this->Slice = 0;
+	this->Component = 0;
+	this->BoundaryMode = BINARY;
+	this->SubSamples = 16;
+	this->ResliceAxes = nullptr;
+	this->ResliceSpacing[0] = this->ResliceSpacing[1] = 0.0;
+	this->InterpolationMode = NEAREST;
+	this->Annulus = 0;
+	this->AnnulusInnerScale = 1.0;
+	this->AnnulusOuterScale = 1.5;
+	this->Reproducible = 0;
+	this->CompensatedSummation = 0;
+	this->Cache = nullptr;
+	this->PixelArea = 1.0;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseStatistics::~vtkEllipseStatistics()
+{
+	this->SetInputData(nullptr);
+	this->SetResliceAxes(nullptr);
+	this->SetCache(nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::SetInputData(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::SetResliceAxes(vtkMatrix4x4 *axes)
+{
+	vtkSetObjectBodyMacro(ResliceAxes, vtkMatrix4x4, axes);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::SetCache(vtkEllipseStatisticsCache *cache)
+{
+	vtkSetObjectBodyMacro(Cache, vtkEllipseStatisticsCache, cache);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::SetCorners(const double p1[2], const double p2[2])
+{
+	this->SetCenter(0.5 * (p1[0] + p2[0]), 0.5 * (p1[1] + p2[1]));
+	this->SetRadius(0.5 * fabs(p2[0] - p1[0]), 0.5 * fabs(p2[1] - p1[1]));
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipseStatistics::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Input)
+	{
+		mTime = std::max(mTime, this->Input->GetMTime());
+	}
+	if (this->ResliceAxes)
+	{
+		mTime = std::max(mTime, this->ResliceAxes->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		if (!this->Cache || !this->Cache->Restore(this))
+		{
+			this->Compute();
+			if (this->Cache)
+			{
+				this->Cache->Store(this);
+			}
+		}
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::ComputeBatch(vtkDataArray *parameters, vtkDoubleArray *output)
+{
+	if (!parameters || !output)
+	{
+		return;
+	}
+	if (parameters->GetNumberOfComponents() != 4)
+	{
+		vtkErrorMacro(<< "Ellipse parameters with four components are required");
+		return;
+	}
+
+	static const char *names[] = { "Count", "Area", "Mean", "StandardDeviation",
+		"Minimum", "Maximum", "RingCount", "RingArea", "RingMean",
+		"RingStandardDeviation", "RingMinimum", "RingMaximum" };
+	int components = this->Annulus ? 12 : 6;
+	vtkIdType n = parameters->GetNumberOfTuples();
+	output->Initialize();
+	output->SetNumberOfComponents(components);
+	for (int c = 0; c < components; c++)
+	{
+		output->SetComponentName(c, names[c]);
+	}
+	output->SetNumberOfTuples(n);
+
+	double center[2] = { this->Center[0], this->Center[1] };
+	double radius[2] = { this->Radius[0], this->Radius[1] };
+	for (vtkIdType i = 0; i < n; i++)
+	{
+		double p[4];
+		parameters->GetTuple(i, p);
+		this->SetCenter(p[0], p[1]);
+		this->SetRadius(p[2], p[3]);
+		this->Update();
+
+		double *tuple = output->GetPointer(i * components);
+		tuple[0] = this->GetCount();
+		tuple[1] = this->GetArea();
+		tuple[2] = this->GetMean();
+		tuple[3] = this->GetStandardDeviation();
+		tuple[4] = this->GetMinimum();
+		tuple[5] = this->GetMaximum();
+		if (this->Annulus)
+		{
+			tuple[6] = this->GetRingCount();
+			tuple[7] = this->GetRingArea();
+			tuple[8] = this->GetRingMean();
+			tuple[9] = this->GetRingStandardDeviation();
+			tuple[10] = this->GetRingMinimum();
+			tuple[11] = this->GetRingMaximum();
+		}
+	}
+	this->SetCenter(center);
+	this->SetRadius(radius);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::Compute()
+{
+	this->Result = vtkEllipseStatisticsAccumulator();
+	this->RingResult = vtkEllipseStatisticsAccumulator();
+
+	vtkDataArray *scalars = this->Input ? this->Input->GetPointData()->GetScalars() : nullptr;
+	if (!scalars)
+	{
+		vtkErrorMacro(<< "No input scalars to compute statistics on");
+		return;
+	}
+	if (this->Component >= scalars->GetNumberOfComponents())
+	{
+		vtkErrorMacro(<< "Component " << this->Component << " is out of range");
+		return;
+	}
+
+	int extent[6];
+	double origin[3], spacing[3];
+	vtkIdType increments[3];
+	this->Input->GetExtent(extent);
+	this->Input->GetOrigin(origin);
+	this->Input->GetSpacing(spacing);
+	this->Input->GetIncrements(increments);
+
+	if (this->ResliceAxes)
+	{
+		this->ComputeOblique(scalars->GetDataType(), extent, origin, spacing, increments);
+		return;
+	}
+
+	if (this->Slice < extent[4] || this->Slice > extent[5])
+	{
+		vtkErrorMacro(<< "Slice " << this->Slice << " is outside of the input extent");
+		return;
+	}
+
+	// The ellipse in continuous index coordinates
+	this->PixelArea = fabs(spacing[0] * spacing[1]);
+	double center[2] = {
+		(this->Center[0] - origin[0]) / spacing[0],
+		(this->Center[1] - origin[1]) / spacing[1] };
+	double radius[2] = {
+		this->Radius[0] / fabs(spacing[0]),
+		this->Radius[1] / fabs(spacing[1]) };
+	vtkEllipseScanline scanline(center, radius);
+	if (!scanline.IsValid())
+	{
+		return;
+	}
+
+	void *base = this->Input->GetScalarPointer(extent[0], extent[2], this->Slice);
+
+	switch (scalars->GetDataType())
+	{
+		vtkTemplateMacro(vtkEllipseStatisticsSliceExecute(this,
+			static_cast<const VTK_TT*>(base) + this->Component, increments, extent,
+			scanline, this->Result, this->RingResult));
+	default:
+		vtkErrorMacro(<< "Unsupported scalar type");
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::ComputeOblique(int scalarType, const int extent[6],
+	const double origin[3], const double spacing[3], const vtkIdType increments[3])
+{
+	// Sampling grid of the plane, with its origin at the origin of the plane
+	double minSpacing = std::min(fabs(spacing[0]), std::min(fabs(spacing[1]), fabs(spacing[2])));
+	double planeSpacing[2] = {
+		this->ResliceSpacing[0] > 0.0 ? this->ResliceSpacing[0] : minSpacing,
+		this->ResliceSpacing[1] > 0.0 ? this->ResliceSpacing[1] : minSpacing };
+	this->PixelArea = planeSpacing[0] * planeSpacing[1];
+	double center[2] = {
+		this->Center[0] / planeSpacing[0],
+		this->Center[1] / planeSpacing[1] };
+	double radius[2] = {
+		this->Radius[0] / planeSpacing[0],
+		this->Radius[1] / planeSpacing[1] };
+	vtkEllipseScanline scanline(center, radius);
+	if (!scanline.IsValid())
+	{
+		return;
+	}
+
+	// Pixel (i, j) of the plane in continuous volume index coordinates
+	double planeOrigin[3], u[3], v[3];
+	for (int a = 0; a < 3; a++)
+	{
+		planeOrigin[a] = (this->ResliceAxes->GetElement(a, 3) - origin[a]) / spacing[a];
+		u[a] = this->ResliceAxes->GetElement(a, 0) * planeSpacing[0] / spacing[a];
+		v[a] = this->ResliceAxes->GetElement(a, 1) * planeSpacing[1] / spacing[a];
+	}
+
+	void *base = this->Input->GetScalarPointer(extent[0], extent[2], extent[4]);
+
+	switch (scalarType)
+	{
+		vtkTemplateMacro(vtkEllipseStatisticsResliceExecute(this,
+			static_cast<const VTK_TT*>(base) + this->Component, increments, extent,
+			planeOrigin, u, v, scanline, this->Result, this->RingResult));
+	default:
+		vtkErrorMacro(<< "Unsupported scalar type");
+	}
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseStatistics::GetArea()
+{
+	return this->Result.Weight * this->PixelArea;
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseStatistics::GetStandardDeviation()
+{
+	return sqrt(this->Result.GetVariance());
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseStatistics::GetRingArea()
+{
+	return this->RingResult.Weight * this->PixelArea;
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipseStatistics::GetRingStandardDeviation()
+{
+	return sqrt(this->RingResult.GetVariance());
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Center: (" << this->Center[0] << ", " << this->Center[1] << ")\n";
+	os << indent << "Radius: (" << this->Radius[0] << ", " << this->Radius[1] << ")\n";
+	os << indent << "Slice: " << this->Slice << "\n";
+	os << indent << "Component: " << this->Component << "\n";
+	os << indent << "Boundary Mode: "
+		<< (this->BoundaryMode == PARTIAL_VOLUME ? "Partial Volume\n" : "Binary\n");
+	os << indent << "Sub Samples: " << this->SubSamples << "\n";
+	os << indent << "Reslice Axes: " << this->ResliceAxes << "\n";
+	os << indent << "Reslice Spacing: (" << this->ResliceSpacing[0] << ", "
+		<< this->ResliceSpacing[1] << ")\n";
+	os << indent << "Annulus: " << (this->Annulus ? "On\n" : "Off\n");
+	os << indent << "Annulus Inner Scale: " << this->AnnulusInnerScale << "\n";
+	os << indent << "Annulus Outer Scale: " << this->AnnulusOuterScale << "\n";
+	os << indent << "Reproducible: " << (this->Reproducible ? "On\n" : "Off\n");
+	os << indent << "Compensated Summation: "
+		<< (this->CompensatedSummation ? "On\n" : "Off\n");
+	os << indent << "Cache: " << this->Cache << "\n";
+	os << indent << "Interpolation Mode: "
+		<< (this->InterpolationMode == LINEAR ? "Linear\n" : "Nearest\n");
+	os << indent << "Count: " << this->GetCount() << "\n";
+	os << indent << "Mean: " << this->GetMean() << "\n";
+	os << indent << "Standard Deviation: " << this->GetStandardDeviation() << "\n";
+	os << indent << "Minimum: " << this->GetMinimum() << "\n";
+	os << indent << "Maximum: " << this->GetMaximum() << "\n";
+	if (this->Annulus)
+	{
+		os << indent << "Ring Count: " << this->GetRingCount() << "\n";
+		os << indent << "Ring Mean: " << this->GetRingMean() << "\n";
+		os << indent << "Ring Standard Deviation: " << this->GetRingStandardDeviation() << "\n";
+	}
+}
@@ -0,0 +1,457 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseStatistics.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseStatistics
+* @brief   intensity statistics of an image inside an ellipse ROI
+*
+* vtkEllipseStatistics computes the pixel count, area, mean, variance,
+* minimum and maximum of one scalar component of a vtkImageData slice inside
+* an axis aligned ellipse given in world coordinates (e.g., the corners of a
+* world anchored vtkEllipseRepresentation). The ellipse is rasterized into
+* analytic scanline spans (see vtkEllipseScanline) and the rows are processed
+* in parallel with vtkSMPTools.
+*
+* Two boundary modes are supported. In BINARY mode a pixel belongs to the
+* ROI when its center is inside the ellipse. In PARTIAL_VOLUME mode every
+* pixel is weighted by the fraction of its area covered by the ellipse and
+* the statistics are area weighted. Interior pixels are still accumulated
+* span by span at full speed, and the coverage is only evaluated for the
+* boundary pixels of each row (exactly along the row, sampled over
+* SubSamples sub-rows across it), so the extra cost is proportional to the
+* perimeter of the ROI, not to its area.
+*
+* The ellipse can also be measured on an oblique plane through a volume, as
+* displayed by vtkImageReslice, by giving the reslice axes of the plane. The
+* spans of the ellipse on the plane are then mapped incrementally to volume
+* index space and the volume is sampled with nearest neighbor or trilinear
+* interpolation along them; no resliced image is created and only the
+* voxels under the ROI are read.
+*
+* With Annulus on, the statistics of a concentric background ring are
+* computed in the same pass, e.g., for signal-to-noise or contrast
+* measurements. The ring lies between the ellipse scaled by
+* AnnulusInnerScale and by AnnulusOuterScale; each row is split analytically
+* into the ellipse span and the ring segments, and the ring boundaries are
+* weighted like the ellipse boundary in PARTIAL_VOLUME mode.
+*
+* By default the per-thread sums are merged as they come, so the last bits
+* of the results depend on the number of threads and on how the rows were
+* scheduled. With Reproducible on, the rows are summed in chunks of a fixed
+* number of rows and the chunk sums are merged pairwise in a fixed order:
+* the results are then identical for any number of threads, and optionally
+* more accurate with CompensatedSummation.
+*
+* @sa
+* vtkEllipseRepresentation vtkEllipseScanline vtkImageReslice
+*/
+
+#ifndef vtkEllipseStatistics_h
+#define vtkEllipseStatistics_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+#include <algorithm> // For vtkEllipseStatisticsAccumulator
+#include <cmath> // For vtkEllipseCompensatedAccumulator
+#include <vector> // For vtkEllipseStatisticsPairwiseMerge
+
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkEllipseStatisticsCache;
+
+#ifndef __VTK_WRAP__
+/**
+* Running, mergeable sums of a (possibly weighted) set of samples. Shared by
+* the ROI statistics classes.
+*/
+struct vtkEllipseStatisticsAccumulator
+{
+	double Weight = 0.0;
+	double Sum = 0.0;
+	double SumOfSquares = 0.0;
+	double Minimum = VTK_DOUBLE_MAX;
+	double Maximum = VTK_DOUBLE_MIN;
+
+	void Add(double value)
+	{
+		this->Weight += 1.0;
+		this->Sum += value;
+		this->SumOfSquares += value * value;
+		this->Minimum = std::min(this->Minimum, value);
+		this->Maximum = std::max(this->Maximum, value);
+	}
+
+	void Add(double value, double weight)
+	{
+		this->Weight += weight;
+		this->Sum += weight * value;
+		this->SumOfSquares += weight * value * value;
+		this->Minimum = std::min(this->Minimum, value);
+		this->Maximum = std::max(this->Maximum, value);
+	}
+
+	void Merge(const vtkEllipseStatisticsAccumulator &other)
+	{
+		this->Weight += other.Weight;
+		this->Sum += other.Sum;
+		this->SumOfSquares += other.SumOfSquares;
+		this->Minimum = std::min(this->Minimum, other.Minimum);
+		this->Maximum = std::max(this->Maximum, other.Maximum);
+	}
+
+	double GetMean() const
+	{
+		return this->Weight > 0.0 ? this->Sum / this->Weight : 0.0;
+	}
+
+	double GetVariance() const
+	{
+		if (this->Weight <= 0.0)
+		{
+			return 0.0;
+		}
+		double mean = this->Sum / this->Weight;
+		return std::max(this->SumOfSquares / this->Weight - mean * mean, 0.0);
+	}
+};
+
+/**
+* vtkEllipseStatisticsAccumulator with compensated (Kahan-Babuska) sums, for
+* the reproducible mode of the ROI statistics classes.
+*/
+struct vtkEllipseCompensatedAccumulator
+{
+	vtkEllipseStatisticsAccumulator Sums;
+	double WeightError = 0.0;
+	double SumError = 0.0;
+	double SumOfSquaresError = 0.0;
+
+	static void Sum(double &sum, double &error, double value)
+	{
+		double t = sum + value;
+		error += (std::fabs(sum) >= std::fabs(value)) ? (sum - t) + value : (value - t) + sum;
+		sum = t;
+	}
+
+	void Add(double value)
+	{
+		Sum(this->Sums.Weight, this->WeightError, 1.0);
+		Sum(this->Sums.Sum, this->SumError, value);
+		Sum(this->Sums.SumOfSquares, this->SumOfSquaresError, value * value);
+		this->Sums.Minimum = std::min(this->Sums.Minimum, value);
+		this->Sums.Maximum = std::max(this->Sums.Maximum, value);
+	}
+
+	void Add(double value, double weight)
+	{
+		Sum(this->Sums.Weight, this->WeightError, weight);
+		Sum(this->Sums.Sum, this->SumError, weight * value);
+		Sum(this->Sums.SumOfSquares, this->SumOfSquaresError, weight * value * value);
+		this->Sums.Minimum = std::min(this->Sums.Minimum, value);
+		this->Sums.Maximum = std::max(this->Sums.Maximum, value);
+	}
+
+	void Merge(const vtkEllipseCompensatedAccumulator &other)
+	{
+		Sum(this->Sums.Weight, this->WeightError, other.Sums.Weight);
+		Sum(this->Sums.Sum, this->SumError, other.Sums.Sum);
+		Sum(this->Sums.SumOfSquares, this->SumOfSquaresError, other.Sums.SumOfSquares);
+		this->WeightError += other.WeightError;
+		this->SumError += other.SumError;
+		this->SumOfSquaresError += other.SumOfSquaresError;
+		this->Sums.Minimum = std::min(this->Sums.Minimum, other.Sums.Minimum);
+		this->Sums.Maximum = std::max(this->Sums.Maximum, other.Sums.Maximum);
+	}
+
+	vtkEllipseStatisticsAccumulator GetResult() const
+	{
+		vtkEllipseStatisticsAccumulator result = this->Sums;
+		result.Weight += this->WeightError;
+		result.Sum += this->SumError;
+		result.SumOfSquares += this->SumOfSquaresError;
+		return result;
+	}
+};
+
+/**
+* Merge the accumulators of consecutive chunks pairwise into the first one,
+* in an order that only depends on the number of chunks.
+*/
+template <class TAccumulator>
+void vtkEllipseStatisticsPairwiseMerge(std::vector<TAccumulator> &chunks)
+{
+	for (size_t stride = 1; stride < chunks.size(); stride *= 2)
+	{
+		for (size_t i = 0; i + stride < chunks.size(); i += 2 * stride)
+		{
+			chunks[i].Merge(chunks[i + stride]);
+		}
+	}
+}
+#endif
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseStatistics : public vtkObject
+class vtkEllipseStatistics : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseStatistics *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseStatistics, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the image to measure.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipse by its center and semi-axis lengths along x and y,
+	* in world coordinates.
+	*/
+	vtkSetVector2Macro(Center, double);
+	vtkGetVector2Macro(Center, double);
+	vtkSetVector2Macro(Radius, double);
+	vtkGetVector2Macro(Radius, double);
+	//@}
+
+	/**
+	* Convenience method to specify the ellipse by two opposite corners of its
+	* bounding rectangle in world coordinates.
+	*/
+	void SetCorners(const double p1[2], const double p2[2]);
+
+	//@{
+	/**
+	* Specify the slice (the k index, in extent coordinates) and the scalar
+	* component to measure. Both default to 0.
+	*/
+	vtkSetMacro(Slice, int);
+	vtkGetMacro(Slice, int);
+	vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+	vtkGetMacro(Component, int);
+	//@}
+
+	enum { BINARY = 0, PARTIAL_VOLUME };
+
+	//@{
+	/**
+	* Specify how the boundary pixels are handled. BINARY (the default)
+	* includes the pixels whose center is inside the ellipse. PARTIAL_VOLUME
+	* weights each pixel by the fraction of its area inside the ellipse.
+	*/
+	vtkSetClampMacro(BoundaryMode, int, BINARY, PARTIAL_VOLUME);
+	vtkGetMacro(BoundaryMode, int);
+	void SetBoundaryModeToBinary() { this->SetBoundaryMode(BINARY); }
+	void SetBoundaryModeToPartialVolume() { this->SetBoundaryMode(PARTIAL_VOLUME); }
+	//@}
+
+	//@{
+	/**
+	* Number of sub-rows used to integrate the coverage of boundary pixels
+	* in PARTIAL_VOLUME mode. 16 by default.
+	*/
+	vtkSetClampMacro(SubSamples, int, 1, 256);
+	vtkGetMacro(SubSamples, int);
+	//@}
+
+	//@{
+	/**
+	* Specify reslice axes to measure the ellipse on an oblique plane through
+	* the input volume instead of on the slice Slice. The matrix has the same
+	* meaning as in vtkImageReslice: its first two columns are the x and y
+	* axes of the plane and its last column is the world position of the
+	* plane origin; only its affine part is used. Center and Radius are then
+	* given in the coordinates of the plane. nullptr (the default) measures
+	* the axis aligned slice.
+	*/
+	virtual void SetResliceAxes(vtkMatrix4x4 *axes);
+	vtkGetObjectMacro(ResliceAxes, vtkMatrix4x4);
+	//@}
+
+	//@{
+	/**
+	* Sampling spacing along the x and y axes of the oblique plane. A value
+	* that is not positive (the default) uses the smallest spacing of the
+	* input. Ignored without reslice axes.
+	*/
+	vtkSetVector2Macro(ResliceSpacing, double);
+	vtkGetVector2Macro(ResliceSpacing, double);
+	//@}
+
+	//@{
+	/**
+	* Also compute the statistics of a background ring around the ellipse,
+	* between the ellipse scaled by AnnulusInnerScale (1 by default, i.e., the
+	* ellipse itself) and by AnnulusOuterScale (1.5 by default). Off by
+	* default. The ring is empty unless the outer scale exceeds the inner one.
+	*/
+	vtkSetMacro(Annulus, vtkTypeBool);
+	vtkGetMacro(Annulus, vtkTypeBool);
+	vtkBooleanMacro(Annulus, vtkTypeBool);
+	vtkSetClampMacro(AnnulusInnerScale, double, 1.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(AnnulusInnerScale, double);
+	vtkSetClampMacro(AnnulusOuterScale, double, 1.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(AnnulusOuterScale, double);
+	//@}
+
+	enum { NEAREST = 0, LINEAR };
+
+	//@{
+	/**
+	* Specify how the volume is interpolated on an oblique plane: NEAREST
+	* neighbor (the default) or trilinear (LINEAR). Ignored without reslice
+	* axes.
+	*/
+	vtkSetClampMacro(InterpolationMode, int, NEAREST, LINEAR);
+	vtkGetMacro(InterpolationMode, int);
+	void SetInterpolationModeToNearest() { this->SetInterpolationMode(NEAREST); }
+	void SetInterpolationModeToLinear() { this->SetInterpolationMode(LINEAR); }
+	//@}
+
+	enum { REPRODUCIBLE_CHUNK_SIZE = 16 };
+
+	//@{
+	/**
+	* Make the results bit for bit reproducible whatever the number of
+	* threads. The rows of the ROI are split into chunks of
+	* REPRODUCIBLE_CHUNK_SIZE rows, each chunk is summed sequentially, and the
+	* chunk sums are merged pairwise in a fixed tree order. Off by default:
+	* per-thread sums are then merged in scheduling order, which is faster
+	* but may change the last bits of the results from run to run.
+	*/
+	vtkSetMacro(Reproducible, vtkTypeBool);
+	vtkGetMacro(Reproducible, vtkTypeBool);
+	vtkBooleanMacro(Reproducible, vtkTypeBool);
+	//@}
+
+	//@{
+	/**
+	* Use compensated summation in reproducible mode, for sums that are also
+	* accurate to the last bits on large ROIs. Off by default. Ignored unless
+	* Reproducible is on.
+	*/
+	vtkSetMacro(CompensatedSummation, vtkTypeBool);
+	vtkGetMacro(CompensatedSummation, vtkTypeBool);
+	vtkBooleanMacro(CompensatedSummation, vtkTypeBool);
+	//@}
+
+	//@{
+	/**
+	* Specify a cache to reuse the statistics of ROIs that were already
+	* measured on an unchanged image. The cache may be shared by several
+	* statistics objects.
+	*/
+	virtual void SetCache(vtkEllipseStatisticsCache *cache);
+	vtkGetObjectMacro(Cache, vtkEllipseStatisticsCache);
+	//@}
+
+	/**
+	* Compute the statistics if the input or the parameters changed since the
+	* last update, unless they are found in the cache.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* Results of the last update. Count is the (weighted) number of pixels in
+	* the ROI and Area is the same quantity in world units. Minimum and Maximum
+	* are taken over all the pixels with a non-zero weight.
+	*/
+	double GetCount() { return this->Result.Weight; }
+	double GetArea();
+	double GetMean() { return this->Result.GetMean(); }
+	double GetVariance() { return this->Result.GetVariance(); }
+	double GetStandardDeviation();
+	double GetMinimum() { return this->Result.Weight > 0.0 ? this->Result.Minimum : 0.0; }
+	double GetMaximum() { return this->Result.Weight > 0.0 ? this->Result.Maximum : 0.0; }
+	//@}
+
+	//@{
+	/**
+	* Results of the last update for the background ring, when Annulus is on.
+	*/
+	double GetRingCount() { return this->RingResult.Weight; }
+	double GetRingArea();
+	double GetRingMean() { return this->RingResult.GetMean(); }
+	double GetRingVariance() { return this->RingResult.GetVariance(); }
+	double GetRingStandardDeviation();
+	double GetRingMinimum() { return this->RingResult.Weight > 0.0 ? this->RingResult.Minimum : 0.0; }
+	double GetRingMaximum() { return this->RingResult.Weight > 0.0 ? this->RingResult.Maximum : 0.0; }
+	//@}
+
+	/**
+	* Measure a batch of ellipses with the current settings, e.g., from Python
+	* without a call per ROI. Each tuple of parameters is an ellipse (center
+	* x, center y, semi-axis x, semi-axis y). The output gets one tuple per
+	* ellipse with the components Count, Area, Mean, StandardDeviation,
+	* Minimum and Maximum, followed by the same six for the ring when Annulus
+	* is on. The cache is used when one is set. Center and Radius are left
+	* unchanged.
+	*/
+	void ComputeBatch(vtkDataArray *parameters, vtkDoubleArray *output);
+
+	/**
+	* Return the MTime also considering the input image and reslice axes.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipseStatistics();
+	~vtkEllipseStatistics() override;
+
+	vtkImageData *Input;
+	double Center[2];
+	double Radius[2];
+	int Slice;
+	int Component;
+	int BoundaryMode;
+	int SubSamples;
+	vtkMatrix4x4 *ResliceAxes;
+	double ResliceSpacing[2];
+	int InterpolationMode;
+	vtkTypeBool Annulus;
+	double AnnulusInnerScale;
+	double AnnulusOuterScale;
+	vtkTypeBool Reproducible;
+	vtkTypeBool CompensatedSummation;
+
+	vtkEllipseStatisticsAccumulator Result;
+	vtkEllipseStatisticsAccumulator RingResult;
+	vtkEllipseStatisticsCache *Cache;
+	double PixelArea;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+	void ComputeOblique(int scalarType, const int extent[6], const double origin[3],
+		const double spacing[3], const vtkIdType increments[3]);
+
+	friend class vtkEllipseStatisticsCache;
+
+private:
+	vtkEllipseStatistics(const vtkEllipseStatistics&) = delete;
+	void operator=(const vtkEllipseStatistics&) = delete;
+};
+
+#endif
@@ -0,0 +1,296 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseStatisticsCache.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseStatisticsCache.h"
+#include "vtkEllipseStatistics.h"
+#include "vtkImageData.h"
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+vtkStandardNewMacro(vtkEllipseStatisticsCache);
+
+namespace
+{
+// Everything the statistics depend on, as integers so that equal keys
+// compare and hash equal
+struct vtkEllipseStatisticsCacheKey
+{
+	enum { Size = 30 };
+	const void *Image;
+	long long Values[Size];
+
+	bool operator==(const vtkEllipseStatisticsCacheKey &other) const
+	{
+		return this->Image == other.Image &&
+			std::equal(this->Values, this->Values + Size, other.Values);
+	}
+};
+
+struct vtkEllipseStatisticsCacheKeyHash
+{
+	size_t operator()(const vtkEllipseStatisticsCacheKey &key) const
+	{
+		size_t h = std::hash<const void*>()(key.Image);
+		for (int i = 0; i < vtkEllipseStatisticsCacheKey::Size; i++)
+		{
+			h ^= std::hash<long long>()(key.Values[i]) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+		}
+		return h;
+	}
+};
+
+struct vtkEllipseStatisticsCacheEntry
+{
+	vtkEllipseStatisticsCacheKey Key;
+	vtkEllipseStatisticsAccumulator Result;
+	vtkEllipseStatisticsAccumulator RingResult;
+	double PixelArea;
+};
+
+// Exact representation of a double
+long long vtkEllipseStatisticsCacheBits(double value)
+{
+	long long bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+long long vtkEllipseStatisticsCacheQuantize(double value, double quantum)
+{
+	return quantum > 0.0 ? static_cast<long long>(std::floor(value / quantum + 0.5)) :
+		vtkEllipseStatisticsCacheBits(value);
+}
+}
+
+//-------------------------------------------------------------------------
+// Entries are kept in a list from the most to the least recently used, and
+// indexed by key.
+class vtkEllipseStatisticsCache::vtkInternals
+{
+public:
+	typedef std::list<vtkEllipseStatisticsCacheEntry> ListType;
+	ListType Entries;
+	std::unordered_map<vtkEllipseStatisticsCacheKey, ListType::iterator,
+		vtkEllipseStatisticsCacheKeyHash> Index;
+	std::mutex Mutex;
+
+	// Approximate footprint of an entry, including the list and map nodes
+	static vtkIdType EntrySize()
+	{
+		return static_cast<vtkIdType>(sizeof(vtkEllipseStatisticsCacheEntry) +
+			sizeof(vtkEllipseStatisticsCacheKey) + 8 * sizeof(void*));
+	}
+
+	static bool MakeKey(vtkEllipseStatistics *stats, double tolerance,
+		vtkEllipseStatisticsCacheKey &key)
+	{
+		vtkImageData *image = stats->GetInput();
+		if (!image)
+		{
+			return false;
+		}
+		double spacing[3];
+		image->GetSpacing(spacing);
+		double quantum = tolerance *
+			std::min(fabs(spacing[0]), std::min(fabs(spacing[1]), fabs(spacing[2])));
+
+		key.Image = image;
+		long long *v = key.Values;
+		std::fill(v, v + vtkEllipseStatisticsCacheKey::Size, 0);
+		*v++ = static_cast<long long>(image->GetMTime());
+		*v++ = stats->GetSlice();
+		*v++ = stats->GetComponent();
+		*v++ = stats->GetBoundaryMode();
+		*v++ = stats->GetBoundaryMode() == vtkEllipseStatistics::PARTIAL_VOLUME ?
+			stats->GetSubSamples() : 0;
+		*v++ = stats->GetAnnulus() ? 1 : 0;
+		*v++ = stats->GetAnnulus() ?
+			vtkEllipseStatisticsCacheBits(stats->GetAnnulusInnerScale()) : 0;
+		*v++ = stats->GetAnnulus() ?
+			vtkEllipseStatisticsCacheBits(stats->GetAnnulusOuterScale()) : 0;
+		*v++ = stats->GetReproducible() ? 1 : 0;
+		*v++ = stats->GetReproducible() && stats->GetCompensatedSummation() ? 1 : 0;
+		for (int i = 0; i < 2; i++)
+		{
+			*v++ = vtkEllipseStatisticsCacheQuantize(stats->GetCenter()[i], quantum);
+			*v++ = vtkEllipseStatisticsCacheQuantize(stats->GetRadius()[i], quantum);
+		}
+		vtkMatrix4x4 *axes = stats->GetResliceAxes();
+		if (axes)
+		{
+			*v++ = 1;
+			*v++ = stats->GetInterpolationMode();
+			*v++ = vtkEllipseStatisticsCacheBits(stats->GetResliceSpacing()[0]);
+			*v++ = vtkEllipseStatisticsCacheBits(stats->GetResliceSpacing()[1]);
+			for (int r = 0; r < 3; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					*v++ = vtkEllipseStatisticsCacheBits(axes->GetElement(r, c));
+				}
+			}
+		}
+		return true;
+	}
+};
+
+//-------------------------------------------------------------------------
+vtkEllipseStatisticsCache::vtkEllipseStatisticsCache()
+{
+	this->MemoryLimit = 1024;
+	this->Tolerance = 1e-3;
+	this->NumberOfHits = 0;
+	this->NumberOfMisses = 0;
+	this->NumberOfEvictions = 0;
+	this->Internals = new vtkInternals;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseStatisticsCache::~vtkEllipseStatisticsCache()
+{
+	delete this->Internals;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatisticsCache::SetMemoryLimit(vtkIdType limit)
+{
+	limit = std::max(limit, static_cast<vtkIdType>(0));
+	if (limit == this->MemoryLimit)
+	{
+		return;
+	}
+	this->MemoryLimit = limit;
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	this->Evict(1024 * limit / vtkInternals::EntrySize());
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+bool vtkEllipseStatisticsCache::Restore(vtkEllipseStatistics *stats)
+{
+	vtkEllipseStatisticsCacheKey key;
+	if (!vtkInternals::MakeKey(stats, this->Tolerance, key))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	auto found = this->Internals->Index.find(key);
+	if (found == this->Internals->Index.end())
+	{
+		this->NumberOfMisses++;
+		return false;
+	}
+	this->NumberOfHits++;
+
+	// Move the entry to the front of the list
+	vtkInternals::ListType &entries = this->Internals->Entries;
+	entries.splice(entries.begin(), entries, found->second);
+	const vtkEllipseStatisticsCacheEntry &entry = *found->second;
+	stats->Result = entry.Result;
+	stats->RingResult = entry.RingResult;
+	stats->PixelArea = entry.PixelArea;
+	return true;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatisticsCache::Store(vtkEllipseStatistics *stats)
+{
+	vtkEllipseStatisticsCacheEntry entry;
+	if (!vtkInternals::MakeKey(stats, this->Tolerance, entry.Key))
+	{
+		return;
+	}
+	entry.Result = stats->Result;
+	entry.RingResult = stats->RingResult;
+	entry.PixelArea = stats->PixelArea;
+
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	vtkIdType maximumEntries = 1024 * this->MemoryLimit / vtkInternals::EntrySize();
+	if (maximumEntries < 1)
+	{
+		return;
+	}
+	vtkInternals::ListType &entries = this->Internals->Entries;
+	auto found = this->Internals->Index.find(entry.Key);
+	if (found != this->Internals->Index.end())
+	{
+		*found->second = entry;
+		entries.splice(entries.begin(), entries, found->second);
+		return;
+	}
+	this->Evict(maximumEntries - 1);
+	entries.push_front(entry);
+	this->Internals->Index[entry.Key] = entries.begin();
+}
+
+//-------------------------------------------------------------------------
+// Drop the least recently used entries, the mutex must be held
+void vtkEllipseStatisticsCache::Evict(vtkIdType maximumEntries)
+{
+	vtkInternals::ListType &entries = this->Internals->Entries;
+	while (static_cast<vtkIdType>(entries.size()) > maximumEntries)
+	{
+		this->Internals->Index.erase(entries.back().Key);
+		entries.pop_back();
+		this->NumberOfEvictions++;
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatisticsCache::Initialize()
+{
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	this->Internals->Entries.clear();
+	this->Internals->Index.clear();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatisticsCache::ResetCounters()
+{
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	this->NumberOfHits = 0;
+	this->NumberOfMisses = 0;
+	this->NumberOfEvictions = 0;
+}
+
+//-------------------------------------------------------------------------
+vtkIdType vtkEllipseStatisticsCache::GetNumberOfEntries()
+{
+	std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+	return static_cast<vtkIdType>(this->Internals->Entries.size());
+}
+
+//-------------------------------------------------------------------------
+vtkIdType vtkEllipseStatisticsCache::GetMemorySize()
+{
+	return this->GetNumberOfEntries() * vtkInternals::EntrySize();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseStatisticsCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Memory Limit: " << this->MemoryLimit << " KiB\n";
+	os << indent << "Tolerance: " << this->Tolerance << "\n";
+	os << indent << "Number Of Entries: " << this->GetNumberOfEntries() << "\n";
+	os << indent << "Memory Size: " << this->GetMemorySize() << " bytes\n";
+	os << indent << "Number Of Hits: " << this->NumberOfHits << "\n";
+	os << indent << "Number Of Misses: " << this->NumberOfMisses << "\n";
+	os << indent << "Number Of Evictions: " << this->NumberOfEvictions << "\n";
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseStatisticsCache.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseStatisticsCache
+* @brief   least recently used cache of ellipse ROI statistics
+*
+* vtkEllipseStatisticsCache remembers the results of vtkEllipseStatistics
+* so that revisiting a slice or an ROI that did not change (e.g., scrolling
+* back and forth through slices, or toggling between ROIs) costs a hash
+* lookup instead of a new scan of the image. One cache can be shared by any
+* number of vtkEllipseStatistics objects, see vtkEllipseStatistics::SetCache().
+*
+* Entries are keyed on the identity and MTime of the input image, the slice
+* or reslice axes, the component, the statistic options (boundary mode,
+* annulus, interpolation) and the ellipse parameters quantized to Tolerance
+* times the smallest input spacing. Modifying the image therefore never
+* returns stale results, and ellipses moved by less than the tolerance share
+* an entry.
+*
+* The cache holds at most MemoryLimit kibibytes; the least recently used
+* entries are evicted first. Hits, misses and evictions are counted. The
+* cache is thread safe.
+*
+* @sa
+* vtkEllipseStatistics
+*/
+
+#ifndef vtkEllipseStatisticsCache_h
+#define vtkEllipseStatisticsCache_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkEllipseStatistics;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseStatisticsCache : public vtkObject
+class vtkEllipseStatisticsCache : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseStatisticsCache *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseStatisticsCache, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Maximum memory used by the entries, in kibibytes. 1024 by default.
+	* Lowering the limit evicts entries immediately.
+	*/
+	virtual void SetMemoryLimit(vtkIdType limit);
+	vtkGetMacro(MemoryLimit, vtkIdType);
+	//@}
+
+	//@{
+	/**
+	* Quantization step of the ellipse parameters, as a fraction of the
+	* smallest spacing of the image. 1e-3 by default.
+	*/
+	vtkSetClampMacro(Tolerance, double, 0.0, VTK_DOUBLE_MAX);
+	vtkGetMacro(Tolerance, double);
+	//@}
+
+	/**
+	* Look up the statistics matching the current state of the given object
+	* and copy them to it. Return true on a hit.
+	*/
+	bool Restore(vtkEllipseStatistics *stats);
+
+	/**
+	* Store the current results of the given object.
+	*/
+	void Store(vtkEllipseStatistics *stats);
+
+	/**
+	* Remove all the entries. The counters are kept.
+	*/
+	void Initialize();
+
+	/**
+	* Reset the hit, miss and eviction counters.
+	*/
+	void ResetCounters();
+
+	//@{
+	/**
+	* Usage information.
+	*/
+	vtkIdType GetNumberOfEntries();
+	vtkIdType GetMemorySize(); // in bytes
+	vtkGetMacro(NumberOfHits, vtkIdType);
+	vtkGetMacro(NumberOfMisses, vtkIdType);
+	vtkGetMacro(NumberOfEvictions, vtkIdType);
+	//@}
+
+protected:
+	vtkEllipseStatisticsCache();
+	~vtkEllipseStatisticsCache() override;
+
+	vtkIdType MemoryLimit;
+	double Tolerance;
+	vtkIdType NumberOfHits;
+	vtkIdType NumberOfMisses;
+	vtkIdType NumberOfEvictions;
+
+	class vtkInternals;
+	vtkInternals *Internals;
+
+	void Evict(vtkIdType maximumEntries);
+
+private:
+	vtkEllipseStatisticsCache(const vtkEllipseStatisticsCache&) = delete;
+	void operator=(const vtkEllipseStatisticsCache&) = delete;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseTrace.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> vtkEllipseTrace::Enabled(false);
+
+namespace
+{
+struct vtkEllipseTraceEvent
+{
+	const char *Name;
+	long long Begin;
+	long long End;
+};
+
+// The ring buffer of one thread. Only its thread writes to it; Count is the
+// number of events ever recorded, published with release semantics.
+struct vtkEllipseTraceBuffer
+{
+	int ThreadId;
+	std::vector<vtkEllipseTraceEvent> Events;
+	std::atomic<unsigned long long> Count;
+};
+
+// The buffers of all the threads. Buffers are never freed before the end of
+// the program, so that the events of finished threads can still be written.
+struct vtkEllipseTraceRegistry
+{
+	std::mutex Mutex;
+	std::vector<std::unique_ptr<vtkEllipseTraceBuffer> > Buffers;
+	std::atomic<int> BufferSize;
+	std::chrono::steady_clock::time_point Start;
+	std::string ExitFileName;
+
+	vtkEllipseTraceRegistry()
+		: BufferSize(65536), Start(std::chrono::steady_clock::now())
+	{
+	}
+};
+
+vtkEllipseTraceRegistry &vtkEllipseTraceGetRegistry()
+{
+	static vtkEllipseTraceRegistry registry;
+	return registry;
+}
+
+thread_local vtkEllipseTraceBuffer *vtkEllipseTraceLocalBuffer = nullptr;
+
+vtkEllipseTraceBuffer *vtkEllipseTraceCreateBuffer()
+{
+	vtkEllipseTraceRegistry &registry = vtkEllipseTraceGetRegistry();
+	std::unique_ptr<vtkEllipseTraceBuffer> buffer(new vtkEllipseTraceBuffer);
+	buffer->Events.resize(registry.BufferSize.load());
+	buffer->Count.store(0);
+
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	buffer->ThreadId = static_cast<int>(registry.Buffers.size()) + 1;
+	registry.Buffers.push_back(std::move(buffer));
+	return registry.Buffers.back().get();
+}
+
+void vtkEllipseTraceWriteAtExit()
+{
+	vtkEllipseTrace::SetEnabled(false);
+	vtkEllipseTrace::Write(vtkEllipseTraceGetRegistry().ExitFileName.c_str());
+}
+
+// Tracing requested through the environment
+struct vtkEllipseTraceEnvironment
+{
+	vtkEllipseTraceEnvironment()
+	{
+		const char *fileName = getenv("ELLIPSE_TRACE");
+		if (fileName && *fileName)
+		{
+			vtkEllipseTraceGetRegistry().ExitFileName = fileName;
+			std::atexit(vtkEllipseTraceWriteAtExit);
+			vtkEllipseTrace::SetEnabled(true);
+		}
+	}
+};
+vtkEllipseTraceEnvironment vtkEllipseTraceEnvironmentInstance;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseTrace::SetEnabled(bool enabled)
+{
+	vtkEllipseTrace::Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseTrace::SetBufferSize(int size)
+{
+	vtkEllipseTraceGetRegistry().BufferSize.store(std::max(size, 1));
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseTrace::GetBufferSize()
+{
+	return vtkEllipseTraceGetRegistry().BufferSize.load();
+}
+
+//-------------------------------------------------------------------------
+long long vtkEllipseTrace::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - vtkEllipseTraceGetRegistry().Start).count();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseTrace::Record(const char *name, long long begin, long long end)
+{
+	vtkEllipseTraceBuffer *buffer = vtkEllipseTraceLocalBuffer;
+	if (!buffer)
+	{
+		buffer = vtkEllipseTraceLocalBuffer = vtkEllipseTraceCreateBuffer();
+	}
+	unsigned long long n = buffer->Count.load(std::memory_order_relaxed);
+	vtkEllipseTraceEvent &event = buffer->Events[n % buffer->Events.size()];
+	event.Name = name;
+	event.Begin = begin;
+	event.End = end;
+	buffer->Count.store(n + 1, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------
+bool vtkEllipseTrace::Write(const char *filename)
+{
+	if (!filename)
+	{
+		return false;
+	}
+	std::ofstream file(filename);
+	if (!file)
+	{
+		return false;
+	}
+
+	vtkEllipseTraceRegistry &registry = vtkEllipseTraceGetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	const char *separator = "\n";
+	for (const auto &buffer : registry.Buffers)
+	{
+		unsigned long long n = buffer->Count.load(std::memory_order_acquire);
+		unsigned long long size = buffer->Events.size();
+		for (unsigned long long k = n > size ? n - size : 0; k < n; k++)
+		{
+			const vtkEllipseTraceEvent &event = buffer->Events[k % size];
+			file << separator << "{\"name\":\"";
+			for (const char *c = event.Name; *c; c++)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					file << '\\';
+				}
+				file << *c;
+			}
+			// Chrome expects microseconds
+			file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadId
+				<< ",\"ts\":" << 1e-3 * event.Begin
+				<< ",\"dur\":" << 1e-3 * (event.End - event.Begin) << "}";
+			separator = ",\n";
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseTrace::Clear()
+{
+	vtkEllipseTraceRegistry &registry = vtkEllipseTraceGetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	for (const auto &buffer : registry.Buffers)
+	{
+		buffer->Count.store(0, std::memory_order_release);
+	}
+}
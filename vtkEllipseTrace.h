@@ -0,0 +1,118 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseTrace.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseTrace
+* @brief   opt-in timeline tracing of the ellipse widget
+*
+* vtkEllipseTrace records scoped trace events (a name, a thread, a begin and
+* an end time) around the event handlers of vtkEllipseWidget and the build,
+* interaction and render methods of vtkEllipseRepresentation, and writes
+* them as a Chrome trace (JSON "X" events) that can be opened in
+* chrome://tracing or Perfetto to find which mouse event caused a hitch.
+*
+* Tracing is off by default. It is turned on with SetEnabled(), or by
+* setting the environment variable ELLIPSE_TRACE to the name of the file the
+* trace is written to when the program exits. When tracing is off, a scope
+* costs a single relaxed atomic load.
+*
+* Each thread writes its events to its own ring buffer of BufferSize events,
+* without locks; when a buffer is full, the oldest events of that thread are
+* overwritten. Write() should be called while no traced code is running.
+*
+* Instrument a function with vtkEllipseTraceScopeMacro("Class::Method").
+* The name must be a string literal (or otherwise outlive the trace).
+*/
+
+#ifndef vtkEllipseTrace_h
+#define vtkEllipseTrace_h
+
+#include <atomic>
+
+class vtkEllipseTrace
+{
+public:
+	//@{
+	/**
+	* Turn the recording of events on or off.
+	*/
+	static void SetEnabled(bool enabled);
+	static bool GetEnabled()
+	{
+		return vtkEllipseTrace::Enabled.load(std::memory_order_relaxed);
+	}
+	//@}
+
+	//@{
+	/**
+	* Number of events kept per thread, 65536 by default. Only affects the
+	* buffers of the threads that did not record any event yet.
+	*/
+	static void SetBufferSize(int size);
+	static int GetBufferSize();
+	//@}
+
+	/**
+	* Current time in nanoseconds, on the clock of the trace.
+	*/
+	static long long Now();
+
+	/**
+	* Record an event of the calling thread.
+	*/
+	static void Record(const char *name, long long begin, long long end);
+
+	/**
+	* Write the recorded events of all the threads to a Chrome trace file.
+	* Return false if the file could not be written.
+	*/
+	static bool Write(const char *filename);
+
+	/**
+	* Discard the recorded events.
+	*/
+	static void Clear();
+
+private:
+	static std::atomic<bool> Enabled;
+};
+
+/**
+* Record the lifetime of a scope as a trace event, when tracing is enabled.
+*/
+class vtkEllipseTraceScope
+{
+public:
+	explicit vtkEllipseTraceScope(const char *name)
+	{
+		this->Name = vtkEllipseTrace::GetEnabled() ? name : nullptr;
+		this->Begin = this->Name ? vtkEllipseTrace::Now() : 0;
+	}
+
+	~vtkEllipseTraceScope()
+	{
+		if (this->Name)
+		{
+			vtkEllipseTrace::Record(this->Name, this->Begin, vtkEllipseTrace::Now());
+		}
+	}
+
+private:
+	const char *Name;
+	long long Begin;
+
+	vtkEllipseTraceScope(const vtkEllipseTraceScope&) = delete;
+	void operator=(const vtkEllipseTraceScope&) = delete;
+};
+
+#define vtkEllipseTraceScopeMacro(name) \
+	vtkEllipseTraceScope vtkEllipseTraceScopeInstance(name)
+
+#endif
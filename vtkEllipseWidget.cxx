@@ -9,7 +9,10 @@ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 PURPOSE.  See the above copyright notice for more information.
 =========================================================================*/
 #include "vtkEllipseWidget.h"
+#include "vtkEllipseTrace.h"
 #include "vtkEllipseRepresentation.h"
+#include "vtkEllipseRegionSelector.h"
+#include "vtkEllipseGradientPyramid.h"
 #include "vtkCommand.h"
 #include "vtkCallbackCommand.h"
 #include "vtkObjectFactory.h"
@@ -20,9 +23,9 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkWidgetCallbackMapper.h"
 #include "vtkEvent.h"
 #include "vtkWidgetEvent.h"
-#include "vtkActor2D.h"
 #include "vtkProperty2D.h"
-#include "vtkSmartPointer.h"
+
+#include <cmath>
 
 vtkStandardNewMacro(vtkEllipseWidget);
 
@@ -33,6 +36,11 @@ vtkEllipseWidget::vtkEllipseWidget()
 	this->WidgetState = vtkEllipseWidget::Start;
 	this->Selectable = 1;
 	this->Resizable = 1;
+	this->RegionSelector = nullptr;
+	this->EdgeSnapping = 0;
+	this->GradientPyramid = nullptr;
+	this->Dragged = 0;
+	this->Translating = 0;
 
 	this->CallbackMapper->SetCallbackMethod(vtkCommand::LeftButtonPressEvent,
 		vtkWidgetEvent::Select,
@@ -52,7 +60,59 @@ vtkEllipseWidget::vtkEllipseWidget()
 }
 
 //-------------------------------------------------------------------------
-vtkEllipseWidget::~vtkEllipseWidget() = default;
+vtkEllipseWidget::~vtkEllipseWidget()
+{
+	this->SetRegionSelector(nullptr);
+	this->SetGradientPyramid(nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidget::SetRegionSelector(vtkEllipseRegionSelector *selector)
+{
+	vtkSetObjectBodyMacro(RegionSelector, vtkEllipseRegionSelector, selector);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidget::SetGradientPyramid(vtkEllipseGradientPyramid *pyramid)
+{
+	vtkSetObjectBodyMacro(GradientPyramid, vtkEllipseGradientPyramid, pyramid);
+}
+
+//-------------------------------------------------------------------------
+// Refine the world corners of the ellipse on the gradient pyramid
+void vtkEllipseWidget::SnapToEdges()
+{
+	vtkEllipseTraceScopeMacro("vtkEllipseWidget::SnapToEdges");
+
+	vtkEllipseRepresentation *rep = this->GetEllipseRepresentation();
+	if (!this->EdgeSnapping || !this->GradientPyramid || !rep ||
+		rep->GetAnchorMode() != vtkEllipseRepresentation::ANCHOR_WORLD)
+	{
+		return;
+	}
+
+	double w1[3], w2[3];
+	rep->GetWorldCorners(w1, w2);
+	double center[2], radius[2];
+	for (int i = 0; i < 2; i++)
+	{
+		center[i] = 0.5 * (w1[i] + w2[i]);
+		radius[i] = 0.5 * fabs(w2[i] - w1[i]);
+	}
+	if (!this->GradientPyramid->RefineEllipse(center, radius))
+	{
+		return;
+	}
+
+	// Keep the orientation of the corners and the plane of the ellipse
+	for (int i = 0; i < 2; i++)
+	{
+		double sign = (w2[i] >= w1[i] ? 1.0 : -1.0);
+		w1[i] = center[i] - sign * radius[i];
+		w2[i] = center[i] + sign * radius[i];
+	}
+	rep->SetWorldCorners(w1, w2);
+}
 
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::SetCursor(int cState)
@@ -92,8 +152,12 @@ void vtkEllipseWidget::SetCursor(int cState)
 	}
 }
 
-void vtkEllipseWidget::SetEdgeColor(int cState)
+// Highlight the edge on the persistent ellipse property, so that the
+// rendering pipeline of the representation is not needed. Return 1 if the
+// color changed.
+int vtkEllipseWidget::SetEdgeColor(int cState)
 {
+	double color[3] = { 1.0, 1.0, 1.0 };
 	switch (cState)
 	{
 	case vtkEllipseRepresentation::AdjustingP0:
@@ -101,30 +165,27 @@ void vtkEllipseWidget::SetEdgeColor(int cState)
 	case vtkEllipseRepresentation::AdjustingP2:
 	case vtkEllipseRepresentation::AdjustingP3:
 	case vtkEllipseRepresentation::Edge:
-	{
-		vtkSmartPointer<vtkPropCollection>actorCollection = vtkSmartPointer<vtkPropCollection>::New();
-		this->GetEllipseRepresentation()->GetActors2D(actorCollection);
-		vtkActor2D* ellipseActor = (vtkActor2D*)(actorCollection->GetLastProp());
-		ellipseActor->GetProperty()->SetColor(1, 1, 0);
-		this->Interactor->Render();
+		color[2] = 0.0;
 		break;
-	}
 	default:
-	{
-		vtkSmartPointer<vtkPropCollection>actorCollection = vtkSmartPointer<vtkPropCollection>::New();
-		this->GetEllipseRepresentation()->GetActors2D(actorCollection);
-		vtkActor2D* ellipseActor = (vtkActor2D*)(actorCollection->GetLastProp());
-		ellipseActor->GetProperty()->SetColor(1, 1, 1);
-		this->Interactor->Render();
 		break;
 	}
 
+	vtkProperty2D *property = this->GetEllipseRepresentation()->GetEllipseProperty();
+	double *current = property->GetColor();
+	if (current[0] == color[0] && current[1] == color[1] && current[2] == color[2])
+	{
+		return 0;
 	}
+	property->SetColor(color);
+	return 1;
 }
 
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::SelectAction(vtkAbstractWidget *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseWidget::SelectAction");
+
 	vtkEllipseWidget *self = reinterpret_cast<vtkEllipseWidget*>(w);
 
 	if (self->SubclassSelectAction() ||
@@ -136,6 +197,8 @@ void vtkEllipseWidget::SelectAction(vtkAbstractWidget *w)
 	// We are definitely selected
 	self->GrabFocus(self->EventCallbackCommand);
 	self->WidgetState = vtkEllipseWidget::Selected;
+	self->Dragged = 0;
+	self->Translating = 0;
 
 	// Picked something inside the widget
 	int X = self->Interactor->GetEventPosition()[0];
@@ -161,14 +224,17 @@ void vtkEllipseWidget::SelectAction(vtkAbstractWidget *w)
 	if (self->Selectable &&
 		self->WidgetRep->GetInteractionState() == vtkEllipseRepresentation::Inside)
 	{
+		// normalized position within the ellipse bounding box, whatever the
+		// anchor mode of the representation
 		vtkEllipseRepresentation *rep = reinterpret_cast<vtkEllipseRepresentation*>(self->WidgetRep);
-		double *fpos1 = rep->GetPositionCoordinate()->GetValue();
-		double *fpos2 = rep->GetPosition2Coordinate()->GetValue();
-
-		eventPos[0] = (XF - fpos1[0]) / fpos2[0];
-		eventPos[1] = (YF - fpos1[1]) / fpos2[1];
+		double p1[2], p2[2];
+		if (rep->GetDisplayCorners(p1, p2))
+		{
+			eventPos[0] = (X - p1[0]) / (p2[0] - p1[0]);
+			eventPos[1] = (Y - p1[1]) / (p2[1] - p1[1]);
 
-		self->SelectRegion(eventPos);
+			self->SelectRegion(eventPos);
+		}
 	}
 
 	self->EventCallbackCommand->SetAbortFlag(1);
@@ -179,6 +245,8 @@ void vtkEllipseWidget::SelectAction(vtkAbstractWidget *w)
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::TranslateAction(vtkAbstractWidget *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseWidget::TranslateAction");
+
 	vtkEllipseWidget *self = reinterpret_cast<vtkEllipseWidget*>(w);
 
 	if (self->SubclassTranslateAction() ||
@@ -190,6 +258,8 @@ void vtkEllipseWidget::TranslateAction(vtkAbstractWidget *w)
 	// We are definitely selected
 	self->GrabFocus(self->EventCallbackCommand);
 	self->WidgetState = vtkEllipseWidget::Selected;
+	self->Dragged = 0;
+	self->Translating = 1;
 	reinterpret_cast<vtkEllipseRepresentation*>(self->WidgetRep)->MovingOn();
 
 	// Picked something inside the widget
@@ -220,6 +290,8 @@ void vtkEllipseWidget::TranslateAction(vtkAbstractWidget *w)
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::MoveAction(vtkAbstractWidget *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseWidget::MoveAction");
+
 	vtkEllipseWidget *self = reinterpret_cast<vtkEllipseWidget*>(w);
 
 	if (self->SubclassMoveAction())
@@ -238,7 +310,7 @@ void vtkEllipseWidget::MoveAction(vtkAbstractWidget *w)
 		self->WidgetRep->ComputeInteractionState(X, Y);
 		int stateAfter = self->WidgetRep->GetInteractionState();
 		self->SetCursor(stateAfter);
-		self->SetEdgeColor(stateAfter);
+		int recolored = stateBefore != stateAfter && self->SetEdgeColor(stateAfter);
 
 		vtkEllipseRepresentation* EllipseRepresentation =
 			reinterpret_cast<vtkEllipseRepresentation*>(self->WidgetRep);
@@ -251,9 +323,11 @@ void vtkEllipseWidget::MoveAction(vtkAbstractWidget *w)
 			EllipseRepresentation->MovingOn();
 		}
 
-		if (EllipseRepresentation->GetShowEllipse() == vtkEllipseRepresentation::ELLIPSE_ACTIVE &&
+		// a single render, only when the highlight or the visibility changes
+		if (recolored ||
+			(EllipseRepresentation->GetShowEllipse() == vtkEllipseRepresentation::ELLIPSE_ACTIVE &&
 			stateBefore != stateAfter &&
-			(stateBefore == vtkEllipseRepresentation::Outside || stateAfter == vtkEllipseRepresentation::Outside))
+			(stateBefore == vtkEllipseRepresentation::Outside || stateAfter == vtkEllipseRepresentation::Outside)))
 		{
 			self->Render();
 		}
@@ -271,6 +345,7 @@ void vtkEllipseWidget::MoveAction(vtkAbstractWidget *w)
 	newEventPosition[0] = static_cast<double>(X);
 	newEventPosition[1] = static_cast<double>(Y);
 	self->WidgetRep->WidgetInteraction(newEventPosition);
+	self->Dragged = 1;
 
 	// start a drag
 	self->EventCallbackCommand->SetAbortFlag(1);
@@ -281,6 +356,8 @@ void vtkEllipseWidget::MoveAction(vtkAbstractWidget *w)
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::EndSelectAction(vtkAbstractWidget *w)
 {
+	vtkEllipseTraceScopeMacro("vtkEllipseWidget::EndSelectAction");
+
 	vtkEllipseWidget *self = reinterpret_cast<vtkEllipseWidget*>(w);
 
 	if (self->SubclassEndSelectAction() ||
@@ -295,10 +372,20 @@ void vtkEllipseWidget::EndSelectAction(vtkAbstractWidget *w)
 	self->WidgetState = vtkEllipseWidget::Start;
 	reinterpret_cast<vtkEllipseRepresentation*>(self->WidgetRep)->MovingOff();
 
-	// stop adjusting
+	// only snap an ellipse resized or moved with the left button, not one
+	// that was just clicked or translated with the middle button
+	if (self->Dragged && !self->Translating)
+	{
+		self->SnapToEdges();
+	}
+	self->Dragged = 0;
+	self->Translating = 0;
+
+	// stop adjusting, and render the whole scene at the still update rate
 	self->EventCallbackCommand->SetAbortFlag(1);
 	self->EndInteraction();
 	self->InvokeEvent(vtkCommand::EndInteractionEvent, nullptr);
+	self->Render();
 }
 
 //----------------------------------------------------------------------
@@ -313,7 +400,15 @@ void vtkEllipseWidget::CreateDefaultRepresentation()
 //-------------------------------------------------------------------------
 void vtkEllipseWidget::SelectRegion(double* vtkNotUsed(eventPos[2]))
 {
-	this->InvokeEvent(vtkCommand::WidgetActivateEvent, nullptr);
+	if (!this->RegionSelector)
+	{
+		this->InvokeEvent(vtkCommand::WidgetActivateEvent, nullptr);
+		return;
+	}
+
+	this->RegionSelector->SetRepresentation(this->GetEllipseRepresentation());
+	this->RegionSelector->Update();
+	this->InvokeEvent(vtkCommand::WidgetActivateEvent, this->RegionSelector->GetSelection());
 }
 
 //-------------------------------------------------------------------------
@@ -323,4 +418,7 @@ void vtkEllipseWidget::PrintSelf(ostream& os, vtkIndent indent)
 
 	os << indent << "Selectable: " << (this->Selectable ? "On\n" : "Off\n");
 	os << indent << "Resizable: " << (this->Resizable ? "On\n" : "Off\n");
+	os << indent << "Region Selector: " << this->RegionSelector << "\n";
+	os << indent << "Edge Snapping: " << (this->EdgeSnapping ? "On\n" : "Off\n");
+	os << indent << "Gradient Pyramid: " << this->GradientPyramid << "\n";
 }
\ No newline at end of file
@@ -62,6 +62,17 @@ PURPOSE.  See the above copyright notice for more information.
 *   vtkCommand::InteractionEvent (on vtkWidgetEvent::Move)
 * </pre>
 *
+* @par Edge Snapping:
+* With EdgeSnapping on and a vtkEllipseGradientPyramid set, a world anchored
+* ellipse is snapped to the nearest image boundary when a drag ends, before
+* the EndInteractionEvent is invoked.
+*
+* @par Update Rates:
+* While the widget is dragged, the render window renders at the desired
+* update rate of the interactor (see vtkAbstractWidget::StartInteraction()),
+* so that level of detail props (e.g., volumes) degrade, and the widget
+* renders once at the still update rate when the interaction ends.
+*
 * @sa
 * vtkInteractorObserver vtkCameraInterpolator
 */
@@ -73,6 +84,8 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkAbstractWidget.h"
 
 class vtkEllipseRepresentation;
+class vtkEllipseRegionSelector;
+class vtkEllipseGradientPyramid;
 
 
 //class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseWidget : public vtkAbstractWidget
@@ -140,6 +153,36 @@ public:
 	*/
 	void CreateDefaultRepresentation() override;
 
+	//@{
+	/**
+	* Specify a region selector to run when the interior of the widget is
+	* selected. The selector is given the representation of this widget, and
+	* its vtkSelection is passed as call data of the WidgetActivateEvent.
+	* Without a selector, the event is invoked with no call data.
+	*/
+	virtual void SetRegionSelector(vtkEllipseRegionSelector *selector);
+	vtkGetObjectMacro(RegionSelector, vtkEllipseRegionSelector);
+	//@}
+
+	//@{
+	/**
+	* Indicate whether the ellipse is snapped to the image boundaries when a
+	* left button drag that resized or moved it ends (a click without a drag
+	* and a middle button translation are not snapped): its center and
+	* semi-axes are refined with vtkEllipseGradientPyramid::RefineEllipse()
+	* on the slice and component selected on the pyramid. The widget does
+	* not know which slice is displayed: the caller must keep the Slice of
+	* the pyramid in sync with the slice the ellipse is drawn on. Only world
+	* anchored representations are snapped, and nothing is done without a
+	* pyramid. Off by default.
+	*/
+	vtkSetMacro(EdgeSnapping, vtkTypeBool);
+	vtkGetMacro(EdgeSnapping, vtkTypeBool);
+	vtkBooleanMacro(EdgeSnapping, vtkTypeBool);
+	virtual void SetGradientPyramid(vtkEllipseGradientPyramid *pyramid);
+	vtkGetObjectMacro(GradientPyramid, vtkEllipseGradientPyramid);
+	//@}
+
 protected:
 	vtkEllipseWidget();
 	~vtkEllipseWidget() override;
@@ -155,6 +198,19 @@ protected:
 	vtkTypeBool Selectable;
 	vtkTypeBool Resizable;
 
+	//optional selection of the geometry inside the ellipse
+	vtkEllipseRegionSelector *RegionSelector;
+
+	//snapping of the ellipse to the image boundaries
+	vtkTypeBool EdgeSnapping;
+	vtkEllipseGradientPyramid *GradientPyramid;
+	void SnapToEdges();
+
+	//whether the representation was changed since the button was pressed,
+	//and whether it is a translation with the middle button
+	int Dragged;
+	int Translating;
+
 	//processes the registered events
 	static void SelectAction(vtkAbstractWidget*);
 	static void TranslateAction(vtkAbstractWidget*);
@@ -171,8 +227,8 @@ protected:
 	// helper methods for cursor management
 	void SetCursor(int State) override;
 
-	// helper mathos for edge color highlight
-	void SetEdgeColor(int State);
+	// helper method for edge color highlight, return 1 if the color changed
+	int SetEdgeColor(int State);
 
 	//widget state
 	int WidgetState;
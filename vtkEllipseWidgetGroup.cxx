@@ -0,0 +1,369 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseWidgetGroup.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipseWidgetGroup.h"
+#include "vtkEllipseWidget.h"
+#include "vtkEllipseRepresentation.h"
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkRenderer.h"
+#include "vtkPoints.h"
+#include "vtkCellArray.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper2D.h"
+#include "vtkActor2D.h"
+#include "vtkProperty2D.h"
+#include "vtkTransform.h"
+#include "vtkTransformPolyDataFilter.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipseWidgetGroup);
+
+//-------------------------------------------------------------------------
+struct vtkEllipseWidgetGroupMember
+{
+	vtkSmartPointer<vtkEllipseWidget> Widget;
+	unsigned long Tags[3];
+
+	// Display corners at the start of the drag, for the members drawn by
+	// the proxy actor
+	bool Proxied;
+	double Point1[2];
+	double Point2[2];
+};
+
+//-------------------------------------------------------------------------
+// The members, and the state of the current drag. The affine of the drag
+// maps a display point x to Current1 + Scale * (x - Start1).
+class vtkEllipseWidgetGroup::vtkInternals
+{
+public:
+	std::vector<vtkEllipseWidgetGroupMember> Members;
+
+	vtkEllipseWidget *Leader;
+	vtkRenderer *Renderer;
+	double Start1[2];
+	double Start2[2];
+	double Current1[2];
+	double Scale[2];
+
+	vtkSmartPointer<vtkPolyData> ProxyPolyData;
+	vtkSmartPointer<vtkTransform> ProxyTransform;
+	vtkSmartPointer<vtkTransformPolyDataFilter> ProxyTransformFilter;
+	vtkSmartPointer<vtkPolyDataMapper2D> ProxyMapper;
+	vtkSmartPointer<vtkActor2D> ProxyActor;
+
+	vtkInternals()
+	{
+		this->Leader = nullptr;
+		this->Renderer = nullptr;
+		this->ProxyPolyData = vtkSmartPointer<vtkPolyData>::New();
+		this->ProxyTransform = vtkSmartPointer<vtkTransform>::New();
+		this->ProxyTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+		this->ProxyTransformFilter->SetTransform(this->ProxyTransform);
+		this->ProxyTransformFilter->SetInputData(this->ProxyPolyData);
+		this->ProxyMapper = vtkSmartPointer<vtkPolyDataMapper2D>::New();
+		this->ProxyMapper->SetInputConnection(this->ProxyTransformFilter->GetOutputPort());
+		this->ProxyActor = vtkSmartPointer<vtkActor2D>::New();
+		this->ProxyActor->SetMapper(this->ProxyMapper);
+	}
+
+	std::vector<vtkEllipseWidgetGroupMember>::iterator Find(vtkEllipseWidget *widget)
+	{
+		return std::find_if(this->Members.begin(), this->Members.end(),
+			[widget](const vtkEllipseWidgetGroupMember &m) { return m.Widget == widget; });
+	}
+
+	void Map(const double x[2], double y[2]) const
+	{
+		y[0] = this->Current1[0] + this->Scale[0] * (x[0] - this->Start1[0]);
+		y[1] = this->Current1[1] + this->Scale[1] * (x[1] - this->Start1[1]);
+	}
+};
+
+//-------------------------------------------------------------------------
+vtkEllipseWidgetGroup::vtkEllipseWidgetGroup()
+{
+	this->Dragging = 0;
+	this->ProxyResolution = 32;
+	this->ProxyProperty = vtkProperty2D::New();
+	this->EventCallbackCommand = vtkCallbackCommand::New();
+	this->EventCallbackCommand->SetClientData(this);
+	this->EventCallbackCommand->SetCallback(vtkEllipseWidgetGroup::ProcessEvents);
+	this->Internals = new vtkInternals;
+	this->Internals->ProxyActor->SetProperty(this->ProxyProperty);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseWidgetGroup::~vtkEllipseWidgetGroup()
+{
+	this->RemoveAllWidgets();
+	delete this->Internals;
+	this->EventCallbackCommand->Delete();
+	this->ProxyProperty->Delete();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidgetGroup::AddWidget(vtkEllipseWidget *widget)
+{
+	if (!widget || this->HasWidget(widget))
+	{
+		return;
+	}
+	vtkEllipseWidgetGroupMember member;
+	member.Widget = widget;
+	member.Tags[0] = widget->AddObserver(vtkCommand::StartInteractionEvent,
+		this->EventCallbackCommand);
+	member.Tags[1] = widget->AddObserver(vtkCommand::InteractionEvent,
+		this->EventCallbackCommand);
+	member.Tags[2] = widget->AddObserver(vtkCommand::EndInteractionEvent,
+		this->EventCallbackCommand);
+	member.Proxied = false;
+	this->Internals->Members.push_back(member);
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidgetGroup::RemoveWidget(vtkEllipseWidget *widget)
+{
+	auto it = this->Internals->Find(widget);
+	if (it == this->Internals->Members.end())
+	{
+		return;
+	}
+	if (this->Dragging)
+	{
+		this->EndDrag();
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		it->Widget->RemoveObserver(it->Tags[i]);
+	}
+	this->Internals->Members.erase(it);
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidgetGroup::RemoveAllWidgets()
+{
+	if (this->Dragging)
+	{
+		this->EndDrag();
+	}
+	for (auto &member : this->Internals->Members)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			member.Widget->RemoveObserver(member.Tags[i]);
+		}
+	}
+	this->Internals->Members.clear();
+	this->Modified();
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseWidgetGroup::HasWidget(vtkEllipseWidget *widget)
+{
+	return this->Internals->Find(widget) != this->Internals->Members.end();
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipseWidgetGroup::GetNumberOfWidgets()
+{
+	return static_cast<int>(this->Internals->Members.size());
+}
+
+//-------------------------------------------------------------------------
+vtkEllipseWidget *vtkEllipseWidgetGroup::GetWidget(int i)
+{
+	if (i < 0 || i >= this->GetNumberOfWidgets())
+	{
+		return nullptr;
+	}
+	return this->Internals->Members[i].Widget;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidgetGroup::ProcessEvents(vtkObject *caller, unsigned long event,
+	void *clientdata, void *vtkNotUsed(calldata))
+{
+	vtkEllipseWidgetGroup *self = reinterpret_cast<vtkEllipseWidgetGroup*>(clientdata);
+	vtkEllipseWidget *widget = reinterpret_cast<vtkEllipseWidget*>(caller);
+
+	switch (event)
+	{
+	case vtkCommand::StartInteractionEvent:
+		if (!self->Dragging)
+		{
+			self->StartDrag(widget);
+		}
+		break;
+	case vtkCommand::InteractionEvent:
+		if (self->Dragging && widget == self->Internals->Leader)
+		{
+			self->UpdateDrag();
+		}
+		break;
+	case vtkCommand::EndInteractionEvent:
+		if (self->Dragging && widget == self->Internals->Leader)
+		{
+			self->EndDrag();
+		}
+		break;
+	}
+}
+
+//-------------------------------------------------------------------------
+// Hide the other members and draw their outlines with the proxy actor
+void vtkEllipseWidgetGroup::StartDrag(vtkEllipseWidget *leader)
+{
+	vtkInternals *internals = this->Internals;
+	vtkEllipseRepresentation *leaderRep = leader->GetEllipseRepresentation();
+	vtkRenderer *renderer = leaderRep ? leaderRep->GetRenderer() : nullptr;
+	if (!renderer || !leaderRep->GetDisplayCorners(internals->Start1, internals->Start2))
+	{
+		return;
+	}
+	internals->Leader = leader;
+	internals->Renderer = renderer;
+	internals->Current1[0] = internals->Start1[0];
+	internals->Current1[1] = internals->Start1[1];
+	internals->Scale[0] = internals->Scale[1] = 1.0;
+
+	// The proxy outlines, in viewport coordinates
+	const int n = this->ProxyResolution;
+	int *origin = renderer->GetOrigin();
+	vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+	vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+	std::vector<vtkIdType> ids(n + 1);
+	for (auto &member : internals->Members)
+	{
+		member.Proxied = false;
+		vtkEllipseRepresentation *rep = member.Widget->GetEllipseRepresentation();
+		if (member.Widget == leader || !member.Widget->GetEnabled() || !rep ||
+			rep->GetRenderer() != renderer || !rep->GetVisibility() ||
+			!rep->GetDisplayCorners(member.Point1, member.Point2))
+		{
+			continue;
+		}
+		double cx = 0.5 * (member.Point1[0] + member.Point2[0]) - origin[0];
+		double cy = 0.5 * (member.Point1[1] + member.Point2[1]) - origin[1];
+		double rx = 0.5 * (member.Point2[0] - member.Point1[0]);
+		double ry = 0.5 * (member.Point2[1] - member.Point1[1]);
+		for (int i = 0; i < n; i++)
+		{
+			double theta = 2.0 * vtkMath::Pi() * i / n;
+			ids[i] = points->InsertNextPoint(
+				cx + rx * cos(theta), cy + ry * sin(theta), 0.0);
+		}
+		ids[n] = ids[0];
+		lines->InsertNextCell(n + 1, ids.data());
+
+		member.Proxied = true;
+		rep->VisibilityOff();
+	}
+	internals->ProxyPolyData->SetPoints(points);
+	internals->ProxyPolyData->SetLines(lines);
+	internals->ProxyTransform->Identity();
+	internals->ProxyActor->SetPosition(0.0, 0.0);
+	renderer->AddActor2D(internals->ProxyActor);
+
+	this->Dragging = 1;
+}
+
+//-------------------------------------------------------------------------
+// Follow the leader. A translation only moves the proxy actor; its points
+// are only transformed again when the leader is resized.
+void vtkEllipseWidgetGroup::UpdateDrag()
+{
+	vtkInternals *internals = this->Internals;
+	double p1[2], p2[2];
+	if (!internals->Leader->GetEllipseRepresentation()->GetDisplayCorners(p1, p2))
+	{
+		return;
+	}
+
+	double scale[2];
+	for (int i = 0; i < 2; i++)
+	{
+		double extent = internals->Start2[i] - internals->Start1[i];
+		scale[i] = extent != 0.0 ? (p2[i] - p1[i]) / extent : 1.0;
+	}
+	internals->Current1[0] = p1[0];
+	internals->Current1[1] = p1[1];
+
+	if (scale[0] != internals->Scale[0] || scale[1] != internals->Scale[1])
+	{
+		internals->Scale[0] = scale[0];
+		internals->Scale[1] = scale[1];
+		int *origin = internals->Renderer->GetOrigin();
+		double sx = internals->Start1[0] - origin[0];
+		double sy = internals->Start1[1] - origin[1];
+		internals->ProxyTransform->Identity();
+		internals->ProxyTransform->Translate(sx, sy, 0.0);
+		internals->ProxyTransform->Scale(scale[0], scale[1], 1.0);
+		internals->ProxyTransform->Translate(-sx, -sy, 0.0);
+	}
+	internals->ProxyActor->SetPosition(
+		p1[0] - internals->Start1[0], p1[1] - internals->Start1[1]);
+}
+
+//-------------------------------------------------------------------------
+// Commit the affine of the drag to the members and show them again
+void vtkEllipseWidgetGroup::EndDrag()
+{
+	vtkInternals *internals = this->Internals;
+	this->UpdateDrag();
+
+	bool identity = internals->Scale[0] == 1.0 && internals->Scale[1] == 1.0 &&
+		internals->Current1[0] == internals->Start1[0] &&
+		internals->Current1[1] == internals->Start1[1];
+	for (auto &member : internals->Members)
+	{
+		if (!member.Proxied)
+		{
+			continue;
+		}
+		vtkEllipseRepresentation *rep = member.Widget->GetEllipseRepresentation();
+		if (!identity)
+		{
+			double p1[2], p2[2];
+			internals->Map(member.Point1, p1);
+			internals->Map(member.Point2, p2);
+			rep->SetDisplayCorners(p1, p2);
+		}
+		rep->VisibilityOn();
+		member.Proxied = false;
+	}
+
+	internals->Renderer->RemoveActor2D(internals->ProxyActor);
+	internals->ProxyPolyData->Initialize();
+	internals->Leader = nullptr;
+	internals->Renderer = nullptr;
+	this->Dragging = 0;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipseWidgetGroup::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Number Of Widgets: " << this->GetNumberOfWidgets() << "\n";
+	os << indent << "Dragging: " << (this->Dragging ? "On\n" : "Off\n");
+	os << indent << "Proxy Resolution: " << this->ProxyResolution << "\n";
+	os << indent << "Proxy Property:\n";
+	this->ProxyProperty->PrintSelf(os, indent.GetNextIndent());
+}
@@ -0,0 +1,117 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipseWidgetGroup.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipseWidgetGroup
+* @brief   move or scale a selection of ellipse widgets together
+*
+* vtkEllipseWidgetGroup holds a multi-selection of vtkEllipseWidgets. When
+* any member is dragged (the leader), all the other members follow it: the
+* change of the bounding box of the leader defines a single 2D affine
+* (a scale about the lower left corner of the leader, then a translation)
+* that is applied to the whole group.
+*
+* During the drag the other members are not rebuilt at all. They are hidden
+* and drawn instead by one proxy actor holding all their outlines, built
+* once when the drag starts. Each mouse move only updates the position of
+* the proxy actor (and its transform when the leader is resized), so the
+* cost of an event does not depend on the size of the group. The corners of
+* every member are committed once, when the interaction ends.
+*
+* Only the members rendered by the renderer of the leader follow it.
+*
+* @sa
+* vtkEllipseWidget vtkEllipseRepresentation
+*/
+
+#ifndef vtkEllipseWidgetGroup_h
+#define vtkEllipseWidgetGroup_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkEllipseWidget;
+class vtkProperty2D;
+class vtkCallbackCommand;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipseWidgetGroup : public vtkObject
+class vtkEllipseWidgetGroup : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipseWidgetGroup *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipseWidgetGroup, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Add or remove widgets from the selection. A widget is only added once.
+	* Removing a widget during a group drag ends the drag first.
+	*/
+	void AddWidget(vtkEllipseWidget *widget);
+	void RemoveWidget(vtkEllipseWidget *widget);
+	void RemoveAllWidgets();
+	int HasWidget(vtkEllipseWidget *widget);
+	int GetNumberOfWidgets();
+	vtkEllipseWidget *GetWidget(int i);
+	//@}
+
+	/**
+	* Return whether a group drag is in progress.
+	*/
+	vtkGetMacro(Dragging, vtkTypeBool);
+
+	//@{
+	/**
+	* Number of points of the outlines drawn by the proxy actor. 32 by
+	* default.
+	*/
+	vtkSetClampMacro(ProxyResolution, int, 4, 1024);
+	vtkGetMacro(ProxyResolution, int);
+	//@}
+
+	/**
+	* The property of the proxy actor drawing the other members during a drag.
+	*/
+	vtkGetObjectMacro(ProxyProperty, vtkProperty2D);
+
+protected:
+	vtkEllipseWidgetGroup();
+	~vtkEllipseWidgetGroup() override;
+
+	vtkTypeBool Dragging;
+	int ProxyResolution;
+	vtkProperty2D *ProxyProperty;
+	vtkCallbackCommand *EventCallbackCommand;
+
+	class vtkInternals;
+	vtkInternals *Internals;
+
+	// Handle the interaction events of the members
+	static void ProcessEvents(vtkObject *caller, unsigned long event,
+		void *clientdata, void *calldata);
+	void StartDrag(vtkEllipseWidget *leader);
+	void UpdateDrag();
+	void EndDrag();
+
+private:
+	vtkEllipseWidgetGroup(const vtkEllipseWidgetGroup&) = delete;
+	void operator=(const vtkEllipseWidgetGroup&) = delete;
+};
+
+#endif
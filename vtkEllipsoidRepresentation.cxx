@@ -0,0 +1,460 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidRepresentation.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipsoidRepresentation.h"
+#include "vtkEllipseTrace.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkInteractorObserver.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkActor.h"
+#include "vtkProperty.h"
+#include "vtkSphereSource.h"
+#include "vtkGlyph3D.h"
+#include "vtkTransform.h"
+#include "vtkTransformPolyDataFilter.h"
+#include "vtkPropCollection.h"
+#include "vtkWindow.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(vtkEllipsoidRepresentation);
+
+//-------------------------------------------------------------------------
+vtkEllipsoidRepresentation::vtkEllipsoidRepresentation()
+{
+	this->InteractionState = vtkEllipsoidRepresentation::Outside;
+
+	this->Center[0] = this->Center[1] = this->Center[2] = 0.0;
+	this->Radius[0] = this->Radius[1] = this->Radius[2] = 0.5;
+	this->Tolerance = 5;
+	this->Resolution = 32;
+	this->HandleSize = 0.04;
+	this->Moving = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		this->Bounds[i] = 0.0;
+	}
+
+	// The ellipsoid is drawn as a flat colored wireframe, like the outline of
+	// the 2D widget
+	this->EllipsoidProperty = vtkProperty::New();
+	this->EllipsoidProperty->SetRepresentationToWireframe();
+	this->EllipsoidProperty->SetAmbient(1.0);
+	this->EllipsoidProperty->SetDiffuse(0.0);
+	this->EllipsoidProperty->SetColor(1, 1, 1);
+	this->SelectedEllipsoidProperty = vtkProperty::New();
+	this->SelectedEllipsoidProperty->DeepCopy(this->EllipsoidProperty);
+	this->SelectedEllipsoidProperty->SetColor(1, 1, 0);
+
+	this->EllipsoidSource = vtkSphereSource::New();
+	this->EllipsoidSource->SetRadius(1.0);
+	this->EllipsoidSource->SetThetaResolution(this->Resolution);
+	this->EllipsoidSource->SetPhiResolution(this->Resolution / 2 + 1);
+	this->EllipsoidTransform = vtkTransform::New();
+	this->EllipsoidTransformFilter = vtkTransformPolyDataFilter::New();
+	this->EllipsoidTransformFilter->SetTransform(this->EllipsoidTransform);
+	this->EllipsoidTransformFilter->SetInputConnection(this->EllipsoidSource->GetOutputPort());
+	this->EllipsoidMapper = vtkPolyDataMapper::New();
+	this->EllipsoidMapper->SetInputConnection(this->EllipsoidTransformFilter->GetOutputPort());
+	this->EllipsoidActor = vtkActor::New();
+	this->EllipsoidActor->SetMapper(this->EllipsoidMapper);
+	this->EllipsoidActor->SetProperty(this->EllipsoidProperty);
+
+	// Handles
+	this->HandleProperty = vtkProperty::New();
+	this->HandleProperty->SetColor(1, 1, 1);
+	this->SelectedHandleProperty = vtkProperty::New();
+	this->SelectedHandleProperty->SetColor(1, 1, 0);
+
+	this->HandlePoints = vtkPoints::New();
+	this->HandlePoints->SetDataTypeToDouble();
+	this->HandlePoints->SetNumberOfPoints(6);
+	this->HandlePolyData = vtkPolyData::New();
+	this->HandlePolyData->SetPoints(this->HandlePoints);
+	this->HandleSource = vtkSphereSource::New();
+	this->HandleSource->SetRadius(1.0);
+	this->HandleSource->SetThetaResolution(12);
+	this->HandleSource->SetPhiResolution(8);
+	this->HandleGlyph = vtkGlyph3D::New();
+	this->HandleGlyph->SetInputData(this->HandlePolyData);
+	this->HandleGlyph->SetSourceConnection(this->HandleSource->GetOutputPort());
+	this->HandleGlyph->SetScaleModeToDataScalingOff();
+	this->HandleMapper = vtkPolyDataMapper::New();
+	this->HandleMapper->SetInputConnection(this->HandleGlyph->GetOutputPort());
+	this->HandleActor = vtkActor::New();
+	this->HandleActor->SetMapper(this->HandleMapper);
+	this->HandleActor->SetProperty(this->HandleProperty);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipsoidRepresentation::~vtkEllipsoidRepresentation()
+{
+	this->EllipsoidSource->Delete();
+	this->EllipsoidTransform->Delete();
+	this->EllipsoidTransformFilter->Delete();
+	this->EllipsoidMapper->Delete();
+	this->EllipsoidActor->Delete();
+	this->EllipsoidProperty->Delete();
+	this->SelectedEllipsoidProperty->Delete();
+
+	this->HandlePoints->Delete();
+	this->HandlePolyData->Delete();
+	this->HandleSource->Delete();
+	this->HandleGlyph->Delete();
+	this->HandleMapper->Delete();
+	this->HandleActor->Delete();
+	this->HandleProperty->Delete();
+	this->SelectedHandleProperty->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkEllipsoidRepresentation::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	mTime = std::max(mTime, this->EllipsoidProperty->GetMTime());
+	mTime = std::max(mTime, this->SelectedEllipsoidProperty->GetMTime());
+	mTime = std::max(mTime, this->HandleProperty->GetMTime());
+	mTime = std::max(mTime, this->SelectedHandleProperty->GetMTime());
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::PlaceWidget(double bounds[6])
+{
+	double newBounds[6], center[3];
+	this->AdjustBounds(bounds, newBounds, center);
+	for (int a = 0; a < 3; a++)
+	{
+		this->InitialBounds[2 * a] = newBounds[2 * a];
+		this->InitialBounds[2 * a + 1] = newBounds[2 * a + 1];
+		this->Center[a] = center[a];
+		this->Radius[a] = 0.5 * (newBounds[2 * a + 1] - newBounds[2 * a]);
+	}
+	this->InitialLength = 2.0 * sqrt(this->Radius[0] * this->Radius[0] +
+		this->Radius[1] * this->Radius[1] + this->Radius[2] * this->Radius[2]);
+	this->ValidPick = 1;
+	this->Modified();
+	this->BuildRepresentation();
+}
+
+//-------------------------------------------------------------------------
+double *vtkEllipsoidRepresentation::GetBounds()
+{
+	for (int a = 0; a < 3; a++)
+	{
+		this->Bounds[2 * a] = this->Center[a] - fabs(this->Radius[a]);
+		this->Bounds[2 * a + 1] = this->Center[a] + fabs(this->Radius[a]);
+	}
+	return this->Bounds;
+}
+
+//-------------------------------------------------------------------------
+// Handle h is the end of axis h / 2, on the negative side for even h
+void vtkEllipsoidRepresentation::GetHandlePosition(int handle, double p[3])
+{
+	int axis = handle / 2;
+	p[0] = this->Center[0];
+	p[1] = this->Center[1];
+	p[2] = this->Center[2];
+	p[axis] += (handle % 2 ? 1.0 : -1.0) * this->Radius[axis];
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipsoidRepresentation::GetWorldPerPixel(double &depth)
+{
+	double display[3], world[4];
+	vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer,
+		this->Center[0], this->Center[1], this->Center[2], display);
+	depth = display[2];
+	vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer,
+		display[0] + 1.0, display[1], depth, world);
+	return sqrt(vtkMath::Distance2BetweenPoints(world, this->Center));
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipsoidRepresentation::GetRayLevel(double x, double y)
+{
+	// In the coordinates where the ellipsoid is the unit sphere, the squared
+	// distance of o + t d to the origin is minimal for t = -(o.d) / (d.d)
+	double p0[4], p1[4];
+	vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer, x, y, 0.0, p0);
+	vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer, x, y, 1.0, p1);
+	double o[3], d[3];
+	for (int a = 0; a < 3; a++)
+	{
+		double radius = fabs(this->Radius[a]);
+		if (radius <= 0.0)
+		{
+			return VTK_DOUBLE_MAX;
+		}
+		o[a] = (p0[a] - this->Center[a]) / radius;
+		d[a] = (p1[a] - p0[a]) / radius;
+	}
+	double dd = vtkMath::Dot(d, d);
+	double od = vtkMath::Dot(o, d);
+	double m = vtkMath::Dot(o, o) - (dd > 0.0 ? od * od / dd : 0.0);
+	return sqrt(std::max(m, 0.0));
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipsoidRepresentation::ComputeInteractionState(int X, int Y, int vtkNotUsed(modify))
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidRepresentation::ComputeInteractionState");
+
+	if (!this->Renderer || !this->Renderer->GetRenderWindow())
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::Outside;
+		return this->InteractionState;
+	}
+
+	double depth;
+	double pixel = this->GetWorldPerPixel(depth);
+
+	// check for proximity to the handles first, the closest to the camera
+	// winning when several are under the cursor
+	double handleRadius = this->HandleSize *
+		std::max(fabs(this->Radius[0]), std::max(fabs(this->Radius[1]), fabs(this->Radius[2])));
+	double reach = std::max(static_cast<double>(this->Tolerance),
+		pixel > 0.0 ? handleRadius / pixel : 0.0);
+	int handle = -1;
+	double handleDepth = VTK_DOUBLE_MAX;
+	for (int h = 0; h < 6; h++)
+	{
+		double p[3], display[3];
+		this->GetHandlePosition(h, p);
+		vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, p[0], p[1], p[2], display);
+		double dx = X - display[0];
+		double dy = Y - display[1];
+		if (dx * dx + dy * dy < reach * reach && display[2] < handleDepth)
+		{
+			handle = h;
+			handleDepth = display[2];
+		}
+	}
+	if (handle >= 0)
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::AdjustingXMin + handle;
+		return this->InteractionState;
+	}
+
+	// The distance in pixels from the cursor to the silhouette, to first
+	// order: the ray level is 1 on the silhouette and its gradient on screen
+	// is estimated from the rays one pixel away
+	double level = this->GetRayLevel(X, Y);
+	if (level == VTK_DOUBLE_MAX)
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::Outside;
+		return this->InteractionState;
+	}
+	double gx = this->GetRayLevel(X + 1.0, Y) - level;
+	double gy = this->GetRayLevel(X, Y + 1.0) - level;
+	double gradient = sqrt(gx * gx + gy * gy);
+	double distance = gradient > 0.0 ? (level - 1.0) / gradient :
+		(level > 1.0 ? VTK_DOUBLE_MAX : -VTK_DOUBLE_MAX);
+
+	if (distance > this->Tolerance)
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::Outside;
+	}
+	else if (distance < -this->Tolerance)
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::Inside;
+	}
+	else
+	{
+		this->InteractionState = vtkEllipsoidRepresentation::Edge;
+	}
+	return this->InteractionState;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::StartWidgetInteraction(double eventPos[2])
+{
+	this->StartEventPosition[0] = eventPos[0];
+	this->StartEventPosition[1] = eventPos[1];
+	this->StartEventPosition[2] = 0.0;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::WidgetInteraction(double eventPos[2])
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidRepresentation::WidgetInteraction");
+
+	if (!this->Renderer)
+	{
+		return;
+	}
+
+	// The motion of the cursor on the plane through the center parallel to
+	// the view plane
+	double depth;
+	this->GetWorldPerPixel(depth);
+	double from[4], to[4];
+	vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer,
+		this->StartEventPosition[0], this->StartEventPosition[1], depth, from);
+	vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer,
+		eventPos[0], eventPos[1], depth, to);
+	double delta[3] = { to[0] - from[0], to[1] - from[1], to[2] - from[2] };
+
+	double center[3] = { this->Center[0], this->Center[1], this->Center[2] };
+	double radius[3] = { this->Radius[0], this->Radius[1], this->Radius[2] };
+	switch (this->InteractionState)
+	{
+	case vtkEllipsoidRepresentation::AdjustingXMin:
+	case vtkEllipsoidRepresentation::AdjustingXMax:
+	case vtkEllipsoidRepresentation::AdjustingYMin:
+	case vtkEllipsoidRepresentation::AdjustingYMax:
+	case vtkEllipsoidRepresentation::AdjustingZMin:
+	case vtkEllipsoidRepresentation::AdjustingZMax:
+	{
+		// move one end of the axis, keeping the other one in place
+		int handle = this->InteractionState - vtkEllipsoidRepresentation::AdjustingXMin;
+		int axis = handle / 2;
+		double sign = (handle % 2 ? 1.0 : -1.0);
+		center[axis] += 0.5 * delta[axis];
+		radius[axis] += 0.5 * sign * delta[axis];
+		break;
+	}
+	case vtkEllipsoidRepresentation::Inside:
+		if (this->Moving)
+		{
+			center[0] += delta[0];
+			center[1] += delta[1];
+			center[2] += delta[2];
+		}
+		break;
+	}
+
+	// Modify the representation
+	if (radius[0] > 0.0 && radius[1] > 0.0 && radius[2] > 0.0)
+	{
+		this->SetCenter(center);
+		this->SetRadius(radius);
+		this->StartEventPosition[0] = eventPos[0];
+		this->StartEventPosition[1] = eventPos[1];
+	}
+
+	this->Modified();
+	this->BuildRepresentation();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::Highlight(int highlight)
+{
+	this->EllipsoidActor->SetProperty(highlight ?
+		this->SelectedEllipsoidProperty : this->EllipsoidProperty);
+	this->HandleActor->SetProperty(highlight ?
+		this->SelectedHandleProperty : this->HandleProperty);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::BuildRepresentation()
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidRepresentation::BuildRepresentation");
+
+	if (this->GetMTime() <= this->BuildTime &&
+		(!this->Renderer || !this->Renderer->GetVTKWindow() ||
+		this->Renderer->GetVTKWindow()->GetMTime() <= this->BuildTime))
+	{
+		return;
+	}
+
+	this->EllipsoidSource->SetThetaResolution(this->Resolution);
+	this->EllipsoidSource->SetPhiResolution(this->Resolution / 2 + 1);
+	this->EllipsoidTransform->Identity();
+	this->EllipsoidTransform->Translate(this->Center);
+	this->EllipsoidTransform->Scale(this->Radius);
+
+	for (int h = 0; h < 6; h++)
+	{
+		double p[3];
+		this->GetHandlePosition(h, p);
+		this->HandlePoints->SetPoint(h, p);
+	}
+	this->HandlePoints->Modified();
+	this->HandleGlyph->SetScaleFactor(this->HandleSize *
+		std::max(fabs(this->Radius[0]), std::max(fabs(this->Radius[1]), fabs(this->Radius[2]))));
+
+	this->BuildTime.Modified();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::GetActors(vtkPropCollection *pc)
+{
+	if (pc)
+	{
+		pc->AddItem(this->EllipsoidActor);
+		pc->AddItem(this->HandleActor);
+	}
+	this->Superclass::GetActors(pc);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::ReleaseGraphicsResources(vtkWindow *w)
+{
+	this->EllipsoidActor->ReleaseGraphicsResources(w);
+	this->HandleActor->ReleaseGraphicsResources(w);
+	this->Superclass::ReleaseGraphicsResources(w);
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipsoidRepresentation::RenderOpaqueGeometry(vtkViewport *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidRepresentation::RenderOpaqueGeometry");
+
+	this->BuildRepresentation();
+	int count = this->EllipsoidActor->RenderOpaqueGeometry(w);
+	count += this->HandleActor->RenderOpaqueGeometry(w);
+	return count;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipsoidRepresentation::RenderTranslucentPolygonalGeometry(vtkViewport *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidRepresentation::RenderTranslucentPolygonalGeometry");
+
+	this->BuildRepresentation();
+	int count = this->EllipsoidActor->RenderTranslucentPolygonalGeometry(w);
+	count += this->HandleActor->RenderTranslucentPolygonalGeometry(w);
+	return count;
+}
+
+//-------------------------------------------------------------------------
+int vtkEllipsoidRepresentation::HasTranslucentPolygonalGeometry()
+{
+	this->BuildRepresentation();
+	return this->EllipsoidActor->HasTranslucentPolygonalGeometry() ||
+		this->HandleActor->HasTranslucentPolygonalGeometry();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Center: (" << this->Center[0] << ", " << this->Center[1] << ", "
+		<< this->Center[2] << ")\n";
+	os << indent << "Radius: (" << this->Radius[0] << ", " << this->Radius[1] << ", "
+		<< this->Radius[2] << ")\n";
+	os << indent << "Tolerance: " << this->Tolerance << "\n";
+	os << indent << "Resolution: " << this->Resolution << "\n";
+	os << indent << "Handle Size: " << this->HandleSize << "\n";
+	os << indent << "Moving: " << (this->Moving ? "On\n" : "Off\n");
+	os << indent << "Ellipsoid Property: " << this->EllipsoidProperty << "\n";
+	os << indent << "Selected Ellipsoid Property: " << this->SelectedEllipsoidProperty << "\n";
+	os << indent << "Handle Property: " << this->HandleProperty << "\n";
+	os << indent << "Selected Handle Property: " << this->SelectedHandleProperty << "\n";
+}
@@ -0,0 +1,230 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidRepresentation.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipsoidRepresentation
+* @brief   represent a vtkEllipsoidWidget
+*
+* This class is used to represent and render a vtkEllipsoidWidget, the
+* volumetric counterpart of vtkEllipseRepresentation. The ellipsoid is axis
+* aligned and defined by its center and semi-axis lengths in world
+* coordinates; it is drawn in 3D with a handle at both ends of each axis.
+*
+* The interaction states follow vtkEllipseRepresentation. The distance, in
+* pixels on screen, from the cursor to the silhouette of the ellipsoid is
+* estimated from the closest approach of the pick ray to the ellipsoid: a
+* cursor within Tolerance pixels of the silhouette is on the Edge, one
+* further inside is Inside. The tolerance therefore only applies in the
+* screen plane, and a thin ellipsoid seen along its short axis can still be
+* grabbed by its interior. A cursor
+* within Tolerance pixels of a handle (or over it) adjusts that end of its
+* axis, the opposite end staying in place. The motion of the cursor is
+* mapped to world coordinates on the plane through the center parallel to
+* the view plane.
+*
+* @sa
+* vtkEllipsoidWidget vtkEllipseRepresentation vtkEllipsoidStatistics
+*/
+
+#ifndef vtkEllipsoidRepresentation_h
+#define vtkEllipsoidRepresentation_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkWidgetRepresentation.h"
+
+class vtkActor;
+class vtkPolyDataMapper;
+class vtkProperty;
+class vtkPoints;
+class vtkPolyData;
+class vtkSphereSource;
+class vtkGlyph3D;
+class vtkTransform;
+class vtkTransformPolyDataFilter;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipsoidRepresentation : public vtkWidgetRepresentation
+class vtkEllipsoidRepresentation : public vtkWidgetRepresentation
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipsoidRepresentation *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipsoidRepresentation, vtkWidgetRepresentation);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipsoid by its center and semi-axis lengths along x, y
+	* and z, in world coordinates.
+	*/
+	vtkSetVector3Macro(Center, double);
+	vtkGetVector3Macro(Center, double);
+	vtkSetVector3Macro(Radius, double);
+	vtkGetVector3Macro(Radius, double);
+	//@}
+
+	//@{
+	/**
+	* Specify the properties of the ellipsoid and of its handles, when the
+	* cursor is away from and on (Highlight) the boundary of the ellipsoid.
+	*/
+	vtkGetObjectMacro(EllipsoidProperty, vtkProperty);
+	vtkGetObjectMacro(SelectedEllipsoidProperty, vtkProperty);
+	vtkGetObjectMacro(HandleProperty, vtkProperty);
+	vtkGetObjectMacro(SelectedHandleProperty, vtkProperty);
+	//@}
+
+	//@{
+	/**
+	* The tolerance representing the distance to the widget (in pixels)
+	* in which the cursor is considered to be on the widget, or on a
+	* widget feature (e.g., a handle or the ellipsoid boundary).
+	*/
+	vtkSetClampMacro(Tolerance, int, 1, 10);
+	vtkGetMacro(Tolerance, int);
+	//@}
+
+	//@{
+	/**
+	* Number of subdivisions of the ellipsoid in longitude and latitude.
+	* 32 by default.
+	*/
+	vtkSetClampMacro(Resolution, int, 4, 1024);
+	vtkGetMacro(Resolution, int);
+	//@}
+
+	//@{
+	/**
+	* Radius of the handles, relative to the largest semi-axis. 0.04 by
+	* default.
+	*/
+	vtkSetClampMacro(HandleSize, double, 0.0, 1.0);
+	vtkGetMacro(HandleSize, double);
+	//@}
+
+	//@{
+	/**
+	* This is a modifier of the interaction state. When set, widget interaction
+	* allows the ellipsoid to be translated with mouse motion.
+	*/
+	vtkSetMacro(Moving, vtkTypeBool);
+	vtkGetMacro(Moving, vtkTypeBool);
+	vtkBooleanMacro(Moving, vtkTypeBool);
+	//@}
+
+	/**
+	* Define the various states that the representation can be in.
+	*/
+	enum _InteractionState
+	{
+		Outside = 0,
+		Inside,
+		Edge,
+		AdjustingXMin,
+		AdjustingXMax,
+		AdjustingYMin,
+		AdjustingYMax,
+		AdjustingZMin,
+		AdjustingZMax
+	};
+
+	/**
+	* Return the MTime of this object. It takes into account MTimes
+	* of the properties.
+	*/
+	vtkMTimeType GetMTime() override;
+
+	//@{
+	/**
+	* Subclasses should implement these methods. See the superclasses'
+	* documentation for more information. Event positions are in display
+	* coordinates. PlaceWidget() fits the ellipsoid in the bounds (scaled by
+	* the place factor).
+	*/
+	void PlaceWidget(double bounds[6]) override;
+	void BuildRepresentation() override;
+	void StartWidgetInteraction(double eventPos[2]) override;
+	void WidgetInteraction(double eventPos[2]) override;
+	int ComputeInteractionState(int X, int Y, int modify = 0) override;
+	void Highlight(int highlight) override;
+	double *GetBounds() override;
+	//@}
+
+	//@{
+	/**
+	* These methods are necessary to make this representation behave as
+	* a vtkProp.
+	*/
+	void GetActors(vtkPropCollection*) override;
+	void ReleaseGraphicsResources(vtkWindow*) override;
+	int RenderOpaqueGeometry(vtkViewport*) override;
+	int RenderTranslucentPolygonalGeometry(vtkViewport*) override;
+	int HasTranslucentPolygonalGeometry() override;
+	//@}
+
+protected:
+	vtkEllipsoidRepresentation();
+	~vtkEllipsoidRepresentation() override;
+
+	// Ivars
+	double Center[3];
+	double Radius[3];
+	int    Tolerance;
+	int    Resolution;
+	double HandleSize;
+	vtkTypeBool Moving;
+	double Bounds[6];
+
+	// The unit sphere scaled and translated onto the ellipsoid
+	vtkSphereSource            *EllipsoidSource;
+	vtkTransform               *EllipsoidTransform;
+	vtkTransformPolyDataFilter *EllipsoidTransformFilter;
+	vtkPolyDataMapper          *EllipsoidMapper;
+	vtkActor                   *EllipsoidActor;
+	vtkProperty                *EllipsoidProperty;
+	vtkProperty                *SelectedEllipsoidProperty;
+
+	// Spheres glyphed at the ends of the axes, in the order of the
+	// Adjusting states
+	vtkPoints                  *HandlePoints;
+	vtkPolyData                *HandlePolyData;
+	vtkSphereSource            *HandleSource;
+	vtkGlyph3D                 *HandleGlyph;
+	vtkPolyDataMapper          *HandleMapper;
+	vtkActor                   *HandleActor;
+	vtkProperty                *HandleProperty;
+	vtkProperty                *SelectedHandleProperty;
+
+	// World position of handle h, the end of axis h / 2 on its negative
+	// (even h) or positive (odd h) side
+	void GetHandlePosition(int handle, double p[3]);
+
+	// World length of a display distance at the depth of the center, and
+	// the display depth of the center
+	double GetWorldPerPixel(double &depth);
+
+	// Closest approach of the pick ray through the display position (x, y)
+	// to the center, in the coordinates where the ellipsoid is the unit
+	// sphere: at most 1 when the ray hits the ellipsoid
+	double GetRayLevel(double x, double y);
+
+private:
+	vtkEllipsoidRepresentation(const vtkEllipsoidRepresentation&) = delete;
+	void operator=(const vtkEllipsoidRepresentation&) = delete;
+};
+
+#endif
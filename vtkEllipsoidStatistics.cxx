@@ -0,0 +1,326 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidStatistics.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipsoidStatistics.h"
+#include "vtkEllipsoidRepresentation.h"
+#include "vtkEllipseScanline.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataArray.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkObjectFactory.h"
+
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkEllipsoidStatistics);
+
+//-------------------------------------------------------------------------
+// Accumulate the voxels of the ellipsoid one (slice, row) pair at a time.
+// Pair m of the bounding extent is row j = J0 + m % Rows of slice
+// k = K0 + m / Rows; the span of the row is computed from the ellipse along
+// which the slice cuts the ellipsoid. In reproducible mode the range of
+// operator() is a range of chunks of pairs, each summed into its own
+// accumulator.
+template <class T>
+class vtkEllipsoidStatisticsFunctor
+{
+public:
+	const T *Base; // first voxel of the extent
+	vtkIdType Increments[3];
+	int Extent[6];
+
+	// The ellipsoid in continuous index coordinates
+	double Center[3];
+	double Radius[3];
+	int J0;
+	int K0;
+	int Rows;
+
+	vtkSMPThreadLocal<vtkEllipseStatisticsAccumulator> Accumulator;
+
+	// Reproducible mode, over Pairs pairs
+	bool Reproducible = false;
+	bool Compensated = false;
+	vtkIdType Pairs = 0;
+	std::vector<vtkEllipseStatisticsAccumulator> Chunks;
+	std::vector<vtkEllipseCompensatedAccumulator> CompensatedChunks;
+
+	void Initialize()
+	{
+	}
+
+	void operator()(vtkIdType begin, vtkIdType end)
+	{
+		if (!this->Reproducible)
+		{
+			this->Accumulate(begin, end, this->Accumulator.Local());
+			return;
+		}
+		const vtkIdType size = vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE;
+		for (vtkIdType c = begin; c < end; c++)
+		{
+			vtkIdType m0 = c * size;
+			vtkIdType m1 = std::min(m0 + size, this->Pairs);
+			if (this->Compensated)
+			{
+				this->Accumulate(m0, m1, this->CompensatedChunks[c]);
+			}
+			else
+			{
+				this->Accumulate(m0, m1, this->Chunks[c]);
+			}
+		}
+	}
+
+	template <class TAccumulator>
+	void Accumulate(vtkIdType begin, vtkIdType end, TAccumulator &acc)
+	{
+		vtkEllipseScanline scanline;
+		int slice = this->K0 - 1;
+		bool valid = false;
+		for (vtkIdType m = begin; m < end; m++)
+		{
+			int k = this->K0 + static_cast<int>(m / this->Rows);
+			int j = this->J0 + static_cast<int>(m % this->Rows);
+			if (k != slice)
+			{
+				// The cross section of the slice
+				slice = k;
+				double w = (k - this->Center[2]) / this->Radius[2];
+				double s = 1.0 - w * w;
+				valid = s > 0.0;
+				if (valid)
+				{
+					double radius[2] = {
+						this->Radius[0] * sqrt(s), this->Radius[1] * sqrt(s) };
+					scanline.SetEllipse(this->Center, radius);
+				}
+			}
+
+			int i0, i1;
+			if (!valid || !scanline.GetSpan(j, i0, i1))
+			{
+				continue;
+			}
+			i0 = std::max(i0, this->Extent[0]);
+			i1 = std::min(i1, this->Extent[1]);
+			const T *p = this->Base + (k - this->Extent[4]) * this->Increments[2] +
+				(j - this->Extent[2]) * this->Increments[1] +
+				(i0 - this->Extent[0]) * this->Increments[0];
+			for (int i = i0; i <= i1; i++, p += this->Increments[0])
+			{
+				acc.Add(static_cast<double>(*p));
+			}
+		}
+	}
+
+	void Reduce()
+	{
+	}
+};
+
+//-------------------------------------------------------------------------
+template <class T>
+void vtkEllipsoidStatisticsExecute(vtkEllipsoidStatistics *self, const T *base, const vtkIdType increments[3],
+	const int extent[6], const double center[3], const double radius[3],
+	const int bounds[6], vtkEllipseStatisticsAccumulator &result)
+{
+	vtkEllipsoidStatisticsFunctor<T> functor;
+	functor.Base = base;
+	std::copy(increments, increments + 3, functor.Increments);
+	std::copy(extent, extent + 6, functor.Extent);
+	std::copy(center, center + 3, functor.Center);
+	std::copy(radius, radius + 3, functor.Radius);
+	functor.J0 = bounds[2];
+	functor.K0 = bounds[4];
+	functor.Rows = bounds[3] - bounds[2] + 1;
+
+	vtkIdType pairs = static_cast<vtkIdType>(functor.Rows) * (bounds[5] - bounds[4] + 1);
+	if (self->GetReproducible())
+	{
+		// One accumulator per chunk, merged in a fixed order
+		const vtkIdType size = vtkEllipseStatistics::REPRODUCIBLE_CHUNK_SIZE;
+		vtkIdType chunks = (pairs + size - 1) / size;
+		functor.Reproducible = true;
+		functor.Compensated = self->GetCompensatedSummation() != 0;
+		functor.Pairs = pairs;
+		if (functor.Compensated)
+		{
+			functor.CompensatedChunks.resize(chunks);
+			vtkSMPTools::For(0, chunks, 1, functor);
+			vtkEllipseStatisticsPairwiseMerge(functor.CompensatedChunks);
+			result = functor.CompensatedChunks[0].GetResult();
+		}
+		else
+		{
+			functor.Chunks.resize(chunks);
+			vtkSMPTools::For(0, chunks, 1, functor);
+			vtkEllipseStatisticsPairwiseMerge(functor.Chunks);
+			result = functor.Chunks[0];
+		}
+		return;
+	}
+	vtkSMPTools::For(0, pairs, functor);
+
+	for (auto it = functor.Accumulator.begin(); it != functor.Accumulator.end(); ++it)
+	{
+		result.Merge(*it);
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkEllipsoidStatistics::vtkEllipsoidStatistics()
+{
+	this->Input = nullptr;
+	this->Center[0] = this->Center[1] = this->Center[2] = 0.0;
+	this->Radius[0] = this->Radius[1] = this->Radius[2] = 1.0;
+	this->Component = 0;
+	this->Reproducible = 0;
+	this->CompensatedSummation = 0;
+	this->VoxelVolume = 1.0;
+}
+
+//-------------------------------------------------------------------------
+vtkEllipsoidStatistics::~vtkEllipsoidStatistics()
+{
+	this->SetInputData(nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidStatistics::SetInputData(vtkImageData *image)
+{
+	vtkSetObjectBodyMacro(Input, vtkImageData, image);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidStatistics::SetEllipsoid(vtkEllipsoidRepresentation *rep)
+{
+	if (rep)
+	{
+		this->SetCenter(rep->GetCenter());
+		this->SetRadius(rep->GetRadius());
+	}
+}
+
+//-------------------------------------------------------------------------
+vtkMTimeType vtkEllipsoidStatistics::GetMTime()
+{
+	vtkMTimeType mTime = this->Superclass::GetMTime();
+	if (this->Input)
+	{
+		mTime = std::max(mTime, this->Input->GetMTime());
+	}
+	return mTime;
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidStatistics::Update()
+{
+	if (this->GetMTime() > this->ComputeTime)
+	{
+		this->Compute();
+		this->ComputeTime.Modified();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidStatistics::Compute()
+{
+	this->Result = vtkEllipseStatisticsAccumulator();
+
+	vtkDataArray *scalars = this->Input ? this->Input->GetPointData()->GetScalars() : nullptr;
+	if (!scalars)
+	{
+		vtkErrorMacro(<< "No input scalars to compute statistics on");
+		return;
+	}
+	if (this->Component >= scalars->GetNumberOfComponents())
+	{
+		vtkErrorMacro(<< "Component " << this->Component << " is out of range");
+		return;
+	}
+
+	int extent[6];
+	double origin[3], spacing[3];
+	vtkIdType increments[3];
+	this->Input->GetExtent(extent);
+	this->Input->GetOrigin(origin);
+	this->Input->GetSpacing(spacing);
+	this->Input->GetIncrements(increments);
+
+	// The ellipsoid in continuous index coordinates, and the voxels of its
+	// bounding box that are inside the extent
+	this->VoxelVolume = fabs(spacing[0] * spacing[1] * spacing[2]);
+	double center[3], radius[3];
+	int bounds[6];
+	for (int a = 0; a < 3; a++)
+	{
+		center[a] = (this->Center[a] - origin[a]) / spacing[a];
+		radius[a] = fabs(this->Radius[a] / spacing[a]);
+		if (radius[a] <= 0.0)
+		{
+			return;
+		}
+		bounds[2 * a] = std::max(static_cast<int>(ceil(center[a] - radius[a])), extent[2 * a]);
+		bounds[2 * a + 1] = std::min(static_cast<int>(floor(center[a] + radius[a])),
+			extent[2 * a + 1]);
+		if (bounds[2 * a] > bounds[2 * a + 1])
+		{
+			return;
+		}
+	}
+
+	void *base = this->Input->GetScalarPointer(extent[0], extent[2], extent[4]);
+
+	switch (scalars->GetDataType())
+	{
+		vtkTemplateMacro(vtkEllipsoidStatisticsExecute(this,
+			static_cast<const VTK_TT*>(base) + this->Component, increments, extent,
+			center, radius, bounds, this->Result));
+	default:
+		vtkErrorMacro(<< "Unsupported scalar type");
+	}
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipsoidStatistics::GetVolume()
+{
+	return this->Result.Weight * this->VoxelVolume;
+}
+
+//-------------------------------------------------------------------------
+double vtkEllipsoidStatistics::GetStandardDeviation()
+{
+	return sqrt(this->Result.GetVariance());
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Input: " << this->Input << "\n";
+	os << indent << "Center: (" << this->Center[0] << ", " << this->Center[1] << ", "
+		<< this->Center[2] << ")\n";
+	os << indent << "Radius: (" << this->Radius[0] << ", " << this->Radius[1] << ", "
+		<< this->Radius[2] << ")\n";
+	os << indent << "Component: " << this->Component << "\n";
+	os << indent << "Reproducible: " << (this->Reproducible ? "On\n" : "Off\n");
+	os << indent << "Compensated Summation: "
+		<< (this->CompensatedSummation ? "On\n" : "Off\n");
+	os << indent << "Count: " << this->GetCount() << "\n";
+	os << indent << "Volume: " << this->GetVolume() << "\n";
+	os << indent << "Mean: " << this->GetMean() << "\n";
+	os << indent << "Standard Deviation: " << this->GetStandardDeviation() << "\n";
+	os << indent << "Minimum: " << this->GetMinimum() << "\n";
+	os << indent << "Maximum: " << this->GetMaximum() << "\n";
+}
@@ -0,0 +1,155 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidStatistics.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipsoidStatistics
+* @brief   intensity statistics of a volume inside an ellipsoid ROI
+*
+* vtkEllipsoidStatistics computes the voxel count, volume, mean, variance,
+* minimum and maximum of one scalar component of a vtkImageData inside an
+* axis aligned ellipsoid given in world coordinates (e.g., the ellipsoid of
+* a vtkEllipsoidRepresentation). A voxel belongs to the ROI when its center
+* is inside the ellipsoid.
+*
+* Each slice of the volume cuts the ellipsoid along an ellipse, whose rows
+* are rasterized into analytic spans (see vtkEllipseScanline). The (slice,
+* row) pairs of the bounding extent of the ellipsoid are processed in
+* parallel with vtkSMPTools, so only the voxels of that extent are visited
+* and only the voxels of the spans are read.
+*
+* As in vtkEllipseStatistics, Reproducible on makes the results identical
+* for any number of threads, with chunks of REPRODUCIBLE_CHUNK_SIZE (slice,
+* row) pairs merged pairwise in a fixed order.
+*
+* @sa
+* vtkEllipsoidRepresentation vtkEllipseStatistics vtkEllipseScanline
+*/
+
+#ifndef vtkEllipsoidStatistics_h
+#define vtkEllipsoidStatistics_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkEllipseStatistics.h" // For vtkEllipseStatisticsAccumulator
+
+class vtkImageData;
+class vtkEllipsoidRepresentation;
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipsoidStatistics : public vtkObject
+class vtkEllipsoidStatistics : public vtkObject
+{
+public:
+	/**
+	* Instantiate this class.
+	*/
+	static vtkEllipsoidStatistics *New();
+
+	//@{
+	/**
+	* Define standard methods.
+	*/
+	vtkTypeMacro(vtkEllipsoidStatistics, vtkObject);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Specify the volume to measure.
+	*/
+	virtual void SetInputData(vtkImageData *image);
+	vtkGetObjectMacro(Input, vtkImageData);
+	//@}
+
+	//@{
+	/**
+	* Specify the ellipsoid by its center and semi-axis lengths along x, y
+	* and z, in world coordinates.
+	*/
+	vtkSetVector3Macro(Center, double);
+	vtkGetVector3Macro(Center, double);
+	vtkSetVector3Macro(Radius, double);
+	vtkGetVector3Macro(Radius, double);
+	//@}
+
+	/**
+	* Convenience method to measure the ellipsoid of a representation.
+	*/
+	void SetEllipsoid(vtkEllipsoidRepresentation *rep);
+
+	//@{
+	/**
+	* Specify the scalar component to measure. 0 by default.
+	*/
+	vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+	vtkGetMacro(Component, int);
+	//@}
+
+	//@{
+	/**
+	* Make the results bit for bit reproducible whatever the number of
+	* threads, optionally with compensated summation. Both are off by
+	* default, see vtkEllipseStatistics::SetReproducible().
+	*/
+	vtkSetMacro(Reproducible, vtkTypeBool);
+	vtkGetMacro(Reproducible, vtkTypeBool);
+	vtkBooleanMacro(Reproducible, vtkTypeBool);
+	vtkSetMacro(CompensatedSummation, vtkTypeBool);
+	vtkGetMacro(CompensatedSummation, vtkTypeBool);
+	vtkBooleanMacro(CompensatedSummation, vtkTypeBool);
+	//@}
+
+	/**
+	* Compute the statistics if the input or the parameters changed since the
+	* last update.
+	*/
+	void Update();
+
+	//@{
+	/**
+	* Results of the last update. Count is the number of voxels in the ROI and
+	* Volume is the same quantity in world units.
+	*/
+	double GetCount() { return this->Result.Weight; }
+	double GetVolume();
+	double GetMean() { return this->Result.GetMean(); }
+	double GetVariance() { return this->Result.GetVariance(); }
+	double GetStandardDeviation();
+	double GetMinimum() { return this->Result.Weight > 0.0 ? this->Result.Minimum : 0.0; }
+	double GetMaximum() { return this->Result.Weight > 0.0 ? this->Result.Maximum : 0.0; }
+	//@}
+
+	/**
+	* Return the MTime also considering the input image.
+	*/
+	vtkMTimeType GetMTime() override;
+
+protected:
+	vtkEllipsoidStatistics();
+	~vtkEllipsoidStatistics() override;
+
+	vtkImageData *Input;
+	double Center[3];
+	double Radius[3];
+	int Component;
+	vtkTypeBool Reproducible;
+	vtkTypeBool CompensatedSummation;
+
+	vtkEllipseStatisticsAccumulator Result;
+	double VoxelVolume;
+	vtkTimeStamp ComputeTime;
+
+	virtual void Compute();
+
+private:
+	vtkEllipsoidStatistics(const vtkEllipsoidStatistics&) = delete;
+	void operator=(const vtkEllipsoidStatistics&) = delete;
+};
+
+#endif
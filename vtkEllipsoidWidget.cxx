@@ -0,0 +1,256 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidWidget.cxx
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+#include "vtkEllipsoidWidget.h"
+#include "vtkEllipseTrace.h"
+#include "vtkEllipsoidRepresentation.h"
+#include "vtkCommand.h"
+#include "vtkCallbackCommand.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkWidgetEventTranslator.h"
+#include "vtkWidgetCallbackMapper.h"
+#include "vtkEvent.h"
+#include "vtkWidgetEvent.h"
+
+vtkStandardNewMacro(vtkEllipsoidWidget);
+
+
+//-------------------------------------------------------------------------
+vtkEllipsoidWidget::vtkEllipsoidWidget()
+{
+	this->WidgetState = vtkEllipsoidWidget::Start;
+	this->Selectable = 1;
+	this->Resizable = 1;
+
+	this->CallbackMapper->SetCallbackMethod(vtkCommand::LeftButtonPressEvent,
+		vtkWidgetEvent::Select,
+		this, vtkEllipsoidWidget::SelectAction);
+	this->CallbackMapper->SetCallbackMethod(vtkCommand::LeftButtonReleaseEvent,
+		vtkWidgetEvent::EndSelect,
+		this, vtkEllipsoidWidget::EndSelectAction);
+	this->CallbackMapper->SetCallbackMethod(vtkCommand::MiddleButtonPressEvent,
+		vtkWidgetEvent::Translate,
+		this, vtkEllipsoidWidget::TranslateAction);
+	this->CallbackMapper->SetCallbackMethod(vtkCommand::MiddleButtonReleaseEvent,
+		vtkWidgetEvent::EndSelect,
+		this, vtkEllipsoidWidget::EndSelectAction);
+	this->CallbackMapper->SetCallbackMethod(vtkCommand::MouseMoveEvent,
+		vtkWidgetEvent::Move,
+		this, vtkEllipsoidWidget::MoveAction);
+}
+
+//-------------------------------------------------------------------------
+vtkEllipsoidWidget::~vtkEllipsoidWidget()
+{
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::SetCursor(int cState)
+{
+	if (!this->Resizable && cState != vtkEllipsoidRepresentation::Inside)
+	{
+		this->RequestCursorShape(VTK_CURSOR_DEFAULT);
+		return;
+	}
+
+	switch (cState)
+	{
+	case vtkEllipsoidRepresentation::AdjustingXMin:
+	case vtkEllipsoidRepresentation::AdjustingXMax:
+	case vtkEllipsoidRepresentation::AdjustingYMin:
+	case vtkEllipsoidRepresentation::AdjustingYMax:
+	case vtkEllipsoidRepresentation::AdjustingZMin:
+	case vtkEllipsoidRepresentation::AdjustingZMax:
+		this->RequestCursorShape(VTK_CURSOR_SIZEALL);
+		break;
+	case vtkEllipsoidRepresentation::Inside:
+		if (this->GetEllipsoidRepresentation()->GetMoving())
+		{
+			this->RequestCursorShape(VTK_CURSOR_SIZEALL);
+		}
+		else
+		{
+			this->RequestCursorShape(VTK_CURSOR_HAND);
+		}
+		break;
+	default:
+		this->RequestCursorShape(VTK_CURSOR_DEFAULT);
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::SelectAction(vtkAbstractWidget *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidWidget::SelectAction");
+
+	vtkEllipsoidWidget *self = reinterpret_cast<vtkEllipsoidWidget*>(w);
+
+	int state = self->WidgetRep->GetInteractionState();
+	if (state == vtkEllipsoidRepresentation::Outside ||
+		state == vtkEllipsoidRepresentation::Edge)
+	{
+		return;
+	}
+
+	// We are definitely selected
+	self->GrabFocus(self->EventCallbackCommand);
+	self->WidgetState = vtkEllipsoidWidget::Selected;
+
+	double eventPos[2];
+	eventPos[0] = static_cast<double>(self->Interactor->GetEventPosition()[0]);
+	eventPos[1] = static_cast<double>(self->Interactor->GetEventPosition()[1]);
+
+	// This is redundant but necessary on some systems (windows) because the
+	// cursor is switched during OS event processing and reverts to the default
+	// cursor.
+	self->SetCursor(state);
+	self->WidgetRep->StartWidgetInteraction(eventPos);
+
+	if (self->Selectable && state == vtkEllipsoidRepresentation::Inside)
+	{
+		self->SelectRegion(eventPos);
+	}
+
+	self->EventCallbackCommand->SetAbortFlag(1);
+	self->StartInteraction();
+	self->InvokeEvent(vtkCommand::StartInteractionEvent, nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::TranslateAction(vtkAbstractWidget *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidWidget::TranslateAction");
+
+	vtkEllipsoidWidget *self = reinterpret_cast<vtkEllipsoidWidget*>(w);
+
+	if (self->WidgetRep->GetInteractionState() == vtkEllipsoidRepresentation::Outside)
+	{
+		return;
+	}
+
+	// We are definitely selected; any part of the widget moves all of it
+	self->GrabFocus(self->EventCallbackCommand);
+	self->WidgetState = vtkEllipsoidWidget::Selected;
+	self->WidgetRep->SetInteractionState(vtkEllipsoidRepresentation::Inside);
+	self->GetEllipsoidRepresentation()->MovingOn();
+	self->SetCursor(vtkEllipsoidRepresentation::Inside);
+
+	double eventPos[2];
+	eventPos[0] = static_cast<double>(self->Interactor->GetEventPosition()[0]);
+	eventPos[1] = static_cast<double>(self->Interactor->GetEventPosition()[1]);
+	self->WidgetRep->StartWidgetInteraction(eventPos);
+
+	self->EventCallbackCommand->SetAbortFlag(1);
+	self->StartInteraction();
+	self->InvokeEvent(vtkCommand::StartInteractionEvent, nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::MoveAction(vtkAbstractWidget *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidWidget::MoveAction");
+
+	vtkEllipsoidWidget *self = reinterpret_cast<vtkEllipsoidWidget*>(w);
+
+	int X = self->Interactor->GetEventPosition()[0];
+	int Y = self->Interactor->GetEventPosition()[1];
+
+	// Set the cursor and the highlight appropriately
+	if (self->WidgetState == vtkEllipsoidWidget::Start)
+	{
+		int stateBefore = self->WidgetRep->GetInteractionState();
+		self->WidgetRep->ComputeInteractionState(X, Y);
+		int stateAfter = self->WidgetRep->GetInteractionState();
+
+		vtkEllipsoidRepresentation *rep = self->GetEllipsoidRepresentation();
+		if (self->Selectable || stateAfter != vtkEllipsoidRepresentation::Inside)
+		{
+			rep->MovingOff();
+		}
+		else
+		{
+			rep->MovingOn();
+		}
+		self->SetCursor(stateAfter);
+
+		if (stateBefore != stateAfter)
+		{
+			rep->Highlight(stateAfter != vtkEllipsoidRepresentation::Outside &&
+				stateAfter != vtkEllipsoidRepresentation::Inside);
+			self->Render();
+		}
+		return;
+	}
+
+	if (!self->Resizable &&
+		self->WidgetRep->GetInteractionState() != vtkEllipsoidRepresentation::Inside)
+	{
+		return;
+	}
+
+	// Okay, adjust the representation (the widget is currently selected)
+	double newEventPosition[2];
+	newEventPosition[0] = static_cast<double>(X);
+	newEventPosition[1] = static_cast<double>(Y);
+	self->WidgetRep->WidgetInteraction(newEventPosition);
+
+	self->EventCallbackCommand->SetAbortFlag(1);
+	self->InvokeEvent(vtkCommand::InteractionEvent, nullptr);
+	self->Render();
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::EndSelectAction(vtkAbstractWidget *w)
+{
+	vtkEllipseTraceScopeMacro("vtkEllipsoidWidget::EndSelectAction");
+
+	vtkEllipsoidWidget *self = reinterpret_cast<vtkEllipsoidWidget*>(w);
+
+	if (self->WidgetState != vtkEllipsoidWidget::Selected)
+	{
+		return;
+	}
+
+	// Return state to not selected
+	self->ReleaseFocus();
+	self->WidgetState = vtkEllipsoidWidget::Start;
+	self->GetEllipsoidRepresentation()->MovingOff();
+
+	// stop adjusting, and render the whole scene at the still update rate
+	self->EventCallbackCommand->SetAbortFlag(1);
+	self->EndInteraction();
+	self->InvokeEvent(vtkCommand::EndInteractionEvent, nullptr);
+	self->Render();
+}
+
+//----------------------------------------------------------------------
+void vtkEllipsoidWidget::CreateDefaultRepresentation()
+{
+	if (!this->WidgetRep)
+	{
+		this->WidgetRep = vtkEllipsoidRepresentation::New();
+	}
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::SelectRegion(double* vtkNotUsed(eventPos[2]))
+{
+	this->InvokeEvent(vtkCommand::WidgetActivateEvent, nullptr);
+}
+
+//-------------------------------------------------------------------------
+void vtkEllipsoidWidget::PrintSelf(ostream& os, vtkIndent indent)
+{
+	this->Superclass::PrintSelf(os, indent);
+
+	os << indent << "Selectable: " << (this->Selectable ? "On\n" : "Off\n");
+	os << indent << "Resizable: " << (this->Resizable ? "On\n" : "Off\n");
+}
@@ -0,0 +1,151 @@
+/*=========================================================================
+Program:   Visualization Toolkit
+Module:    vtkEllipsoidWidget.h
+Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen, Ko Ka Long
+All rights reserved.
+See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+=========================================================================*/
+/**
+* @class   vtkEllipsoidWidget
+* @brief   place an ellipsoid ROI in a 3D scene
+*
+* This class is the volumetric counterpart of vtkEllipseWidget. It places an
+* axis aligned ellipsoid in world coordinates, drawn in 3D by a
+* vtkEllipsoidRepresentation with a handle at both ends of each axis, and
+* is typically measured with vtkEllipsoidStatistics.
+*
+* @par Event Bindings:
+* By default, the widget responds to the following VTK events (i.e., it
+* watches the vtkRenderWindowInteractor for these events):
+* <pre>
+* On a handle of the widget:
+*   LeftButtonPressEvent - select the handle
+*   LeftButtonReleaseEvent - deselect the handle
+*   MouseMoveEvent - move the end of the axis of the handle
+* On the interior of the widget:
+*   LeftButtonPressEvent - invoke SelectRegion() (if the ivar Selectable is
+*                          on), or move the widget otherwise
+* Anywhere on the widget:
+*   MiddleButtonPressEvent - move the widget
+* </pre>
+*
+* @par Event Bindings:
+* When these events are processed, this widget invokes the following VTK
+* events on itself (which observers can listen for):
+* <pre>
+*   vtkCommand::StartInteractionEvent (on vtkWidgetEvent::Select)
+*   vtkCommand::EndInteractionEvent (on vtkWidgetEvent::EndSelect)
+*   vtkCommand::InteractionEvent (on vtkWidgetEvent::Move)
+*   vtkCommand::WidgetActivateEvent (when the interior is selected)
+* </pre>
+*
+* @sa
+* vtkEllipsoidRepresentation vtkEllipseWidget vtkEllipsoidStatistics
+*/
+
+#ifndef vtkEllipsoidWidget_h
+#define vtkEllipsoidWidget_h
+
+#include "vtkInteractionWidgetsModule.h" // For export macro
+#include "vtkAbstractWidget.h"
+
+class vtkEllipsoidRepresentation;
+
+
+//class VTKINTERACTIONWIDGETS_EXPORT vtkEllipsoidWidget : public vtkAbstractWidget
+class vtkEllipsoidWidget : public vtkAbstractWidget
+{
+public:
+	/**
+	* Method to instantiate class.
+	*/
+	static vtkEllipsoidWidget *New();
+
+	//@{
+	/**
+	* Standard methods for class.
+	*/
+	vtkTypeMacro(vtkEllipsoidWidget, vtkAbstractWidget);
+	void PrintSelf(ostream& os, vtkIndent indent) override;
+	//@}
+
+	//@{
+	/**
+	* Indicate whether the interior region of the widget can be selected or
+	* not. If not, then events (such as left mouse down) allow the user to
+	* "move" the widget, and no selection is possible. Otherwise the
+	* SelectRegion() method is invoked.
+	*/
+	vtkSetMacro(Selectable, vtkTypeBool);
+	vtkGetMacro(Selectable, vtkTypeBool);
+	vtkBooleanMacro(Selectable, vtkTypeBool);
+	//@}
+
+	//@{
+	/**
+	* Indicate whether the axes of the widget can be resized with the
+	* handles.
+	*/
+	vtkSetMacro(Resizable, vtkTypeBool);
+	vtkGetMacro(Resizable, vtkTypeBool);
+	vtkBooleanMacro(Resizable, vtkTypeBool);
+	//@}
+
+	/**
+	* Specify an instance of vtkWidgetRepresentation used to represent this
+	* widget in the scene.
+	*/
+	void SetRepresentation(vtkEllipsoidRepresentation *r)
+	{
+		this->Superclass::SetWidgetRepresentation(reinterpret_cast<vtkWidgetRepresentation*>(r));
+	}
+
+	/**
+	* Return the representation as a vtkEllipsoidRepresentation.
+	*/
+	vtkEllipsoidRepresentation *GetEllipsoidRepresentation()
+	{
+		return reinterpret_cast<vtkEllipsoidRepresentation*>(this->WidgetRep);
+	}
+
+	/**
+	* Create the default widget representation if one is not set.
+	*/
+	void CreateDefaultRepresentation() override;
+
+protected:
+	vtkEllipsoidWidget();
+	~vtkEllipsoidWidget() override;
+
+	/**
+	* Invoked when the interior of the widget is selected. Invokes the
+	* WidgetActivateEvent by default.
+	*/
+	virtual void SelectRegion(double eventPos[2]);
+
+	//enable the selection of the region interior to the widget
+	vtkTypeBool Selectable;
+	vtkTypeBool Resizable;
+
+	//processes the registered events
+	static void SelectAction(vtkAbstractWidget*);
+	static void TranslateAction(vtkAbstractWidget*);
+	static void EndSelectAction(vtkAbstractWidget*);
+	static void MoveAction(vtkAbstractWidget*);
+
+	// helper methods for cursor management
+	void SetCursor(int State) override;
+
+	//widget state
+	int WidgetState;
+	enum _WidgetState { Start = 0, Selected };
+
+private:
+	vtkEllipsoidWidget(const vtkEllipsoidWidget&) = delete;
+	void operator=(const vtkEllipsoidWidget&) = delete;
+};
+
+#endif